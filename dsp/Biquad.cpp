@@ -1,81 +1,547 @@
 #include "Biquad.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace mrta
 {
 
-Biquad::Biquad(unsigned int maxNumSections, unsigned int maxNumChannels) :
-    allocatedChannels { maxNumChannels },
-    allocatedSections { maxNumSections },
-    coeffs(allocatedSections * CoeffsPerSection, 0.f),
-    states(allocatedChannels * allocatedSections * StatesPerSection, 0.f)
+template<BiquadTopology Topology, typename Real>
+BiquadCascade<Topology, Real>::BiquadCascade(unsigned int maxNumSections, unsigned int maxNumChannels)
 {
+    allocatedSections = maxNumSections;
+    allocatedChannels = maxNumChannels;
+    reserve(maxNumSections, maxNumChannels);
 }
 
-Biquad::Biquad()
+template<BiquadTopology Topology, typename Real>
+BiquadCascade<Topology, Real>::BiquadCascade()
 {
 }
 
-Biquad::~Biquad()
+template<BiquadTopology Topology, typename Real>
+BiquadCascade<Topology, Real>::~BiquadCascade()
 {
 }
 
-void Biquad::clear()
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::clear()
 {
     std::fill(states.begin(), states.end(), 0.f);
+    interpolateCoeffs = false;
 }
 
-void Biquad::reallocateChannels(unsigned int maxNumChannels)
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::reserve(unsigned int maxNumSections, unsigned int maxNumChannels)
 {
+    reservedSections = maxNumSections;
+    reservedChannels = maxNumChannels;
+    coeffs.resize(reservedSections * CoeffsPerSection, 0.f);
+    states.assign(getNumChannelGroups() * reservedSections * StatesPerSection * LaneWidth, 0.f);
+    interpolateCoeffs = false;
+    sectionStatus.resize(reservedSections);
+    activeSections.resize(reservedSections);
+    drainSamples.resize(reservedSections);
+
+    targetCoeffs.resize(coeffs.size());
+    coeffSteps.resize(coeffs.size());
+    publishedCoeffs = std::make_unique<std::atomic<Real>[]>(coeffs.size());
+    publishedSequence = std::make_unique<std::atomic<unsigned int>[]>(reservedSections);
+    fetchedSequence.resize(reservedSections);
+    resetPublishedCoeffs();
+
+    allocatedSections = std::min(allocatedSections, reservedSections);
+    allocatedChannels = std::min(allocatedChannels, reservedChannels);
+
+    resetSectionStatus();
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::reallocateChannels(unsigned int maxNumChannels)
+{
+    if (maxNumChannels > reservedChannels)
+        reserve(reservedSections, maxNumChannels);
+
     allocatedChannels = maxNumChannels;
-    states.resize(allocatedChannels * allocatedSections * StatesPerSection);
-    std::fill(states.begin(), states.end(), 0.f);
+    clear();
 }
 
-void Biquad::reallocateSections(unsigned int numSections)
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::reallocateSections(unsigned int numSections)
 {
+    if (numSections > reservedSections)
+        reserve(numSections, reservedChannels);
+
     allocatedSections = numSections;
-    coeffs.resize(allocatedSections * CoeffsPerSection);
-    states.resize(allocatedChannels * allocatedSections * StatesPerSection);
     std::fill(coeffs.begin(), coeffs.end(), 0.f);
-    std::fill(states.begin(), states.end(), 0.f);
+    clear();
+    resetPublishedCoeffs();
+    resetSectionStatus();
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::setNumSections(unsigned int numSections)
+{
+    numSections = std::min(numSections, reservedSections);
+
+    // Sections coming into use start as a pass-thru with cleared states
+    const std::array<Real, CoeffsPerSection> flatCoeffs { 1.f, 0.f, 0.f, 0.f, 0.f };
+    for (unsigned int s = allocatedSections; s < numSections; ++s)
+    {
+        std::copy(flatCoeffs.begin(), flatCoeffs.end(), coeffs.begin() + (s * CoeffsPerSection));
+        std::copy(flatCoeffs.begin(), flatCoeffs.end(), targetCoeffs.begin() + (s * CoeffsPerSection));
+        for (unsigned int c = 0; c < reservedChannels; ++c)
+            clearStates(c, s);
+
+        // Anything published while the section was out of use is discarded
+        fetchedSequence[s] = publishedSequence[s].load(std::memory_order_acquire);
+        sectionStatus[s] = Bypassed;
+    }
+
+    allocatedSections = numSections;
+    updateActiveSections();
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::setNumChannels(unsigned int numChannels)
+{
+    numChannels = std::min(numChannels, reservedChannels);
+
+    // Channels coming into use start from cleared states
+    for (unsigned int c = allocatedChannels; c < numChannels; ++c)
+        for (unsigned int s = 0; s < reservedSections; ++s)
+            clearStates(c, s);
+
+    allocatedChannels = numChannels;
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::clearStates(unsigned int channel, unsigned int section)
+{
+    Real* sectionStates { states.data() + getStateOffset(channel, section) };
+    for (unsigned int k = 0; k < StatesPerSection; ++k)
+        sectionStates[k * LaneWidth] = 0.f;
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::setSectionCoeffs(const std::array<Real, CoeffsPerSection>& newSectionCoeffs, unsigned int section)
+{
+    if (section >= reservedSections)
+        return;
+
+    // Make the sequence odd, concurrent publishers of the same section wait for each other
+    // but the audio thread never waits on a publisher
+    std::atomic<unsigned int>& sequence { publishedSequence[section] };
+    unsigned int seq { sequence.load(std::memory_order_relaxed) & ~1u };
+    while (!sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+        seq &= ~1u;
+
+    // The coeffs cannot be seen by the audio thread before the odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::atomic<Real>* sectionCoeffs { publishedCoeffs.get() + section * CoeffsPerSection };
+    for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+        sectionCoeffs[k].store(newSectionCoeffs[k], std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+    publishCount.fetch_add(1, std::memory_order_release);
+}
+
+template<BiquadTopology Topology, typename Real>
+std::array<Real, BiquadCascade<Topology, Real>::CoeffsPerSection> BiquadCascade<Topology, Real>::getSectionCoeffs(unsigned int section) const
+{
+    std::array<Real, CoeffsPerSection> c { };
+    if (section >= reservedSections)
+        return c;
+
+    // Coeffs published after the last fetch are newer than the targets
+    const unsigned int o { section * CoeffsPerSection };
+    if (publishedSequence[section].load(std::memory_order_acquire) != fetchedSequence[section])
+    {
+        for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+            c[k] = publishedCoeffs[o + k].load(std::memory_order_relaxed);
+    }
+    else
+    {
+        std::copy(targetCoeffs.begin() + o, targetCoeffs.begin() + o + CoeffsPerSection, c.begin());
+    }
+
+    return c;
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::resetPublishedCoeffs()
+{
+    std::copy(coeffs.begin(), coeffs.end(), targetCoeffs.begin());
+    std::fill(coeffSteps.begin(), coeffSteps.end(), 0.f);
+
+    for (unsigned int k = 0; k < coeffs.size(); ++k)
+        publishedCoeffs[k].store(coeffs[k], std::memory_order_relaxed);
+
+    for (unsigned int s = 0; s < reservedSections; ++s)
+        fetchedSequence[s] = publishedSequence[s].load(std::memory_order_acquire);
+
+    fetchedPublishCount = publishCount.load(std::memory_order_acquire);
+}
+
+template<BiquadTopology Topology, typename Real>
+bool BiquadCascade<Topology, Real>::fetchPublishedCoeffs(unsigned int numSamples)
+{
+    // Fast path, nothing was published since the last block
+    const unsigned int count { publishCount.load(std::memory_order_acquire) };
+    if (count == fetchedPublishCount)
+        return false;
+
+    bool fetchedAll { true };
+    bool interpolate { false };
+    bool statusChanged { false };
+    const Real stepScale { Real { 1 } / static_cast<Real>(numSamples) };
+    const unsigned int interpolationSamples { interpolateCoeffs ? numSamples : 0 };
+
+    for (unsigned int s = 0; s < allocatedSections; ++s)
+    {
+        const unsigned int seq { publishedSequence[s].load(std::memory_order_acquire) };
+        if (seq == fetchedSequence[s])
+            continue;
+
+        // A publisher is writing this section, try again on the next block
+        if (seq & 1u)
+        {
+            fetchedAll = false;
+            continue;
+        }
+
+        std::array<Real, CoeffsPerSection> c;
+        const std::atomic<Real>* sectionCoeffs { publishedCoeffs.get() + s * CoeffsPerSection };
+        for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+            c[k] = sectionCoeffs[k].load(std::memory_order_relaxed);
+
+        // Discard the read if a publisher started writing in the meantime
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (publishedSequence[s].load(std::memory_order_relaxed) != seq)
+        {
+            fetchedAll = false;
+            continue;
+        }
+
+        fetchedSequence[s] = seq;
+
+        const unsigned int o { s * CoeffsPerSection };
+        std::copy(c.begin(), c.end(), targetCoeffs.begin() + o);
+        if (interpolateCoeffs)
+        {
+            for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+                coeffSteps[o + k] = (targetCoeffs[o + k] - coeffs[o + k]) * stepScale;
+
+            interpolate = true;
+        }
+        else
+        {
+            std::copy(c.begin(), c.end(), coeffs.begin() + o);
+        }
+
+        statusChanged |= updateSectionStatus(s, interpolationSamples);
+    }
+
+    if (fetchedAll)
+        fetchedPublishCount = count;
+
+    if (statusChanged)
+        updateActiveSections();
+
+    return interpolate;
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::finishInterpolation()
+{
+    const unsigned int numCoeffs { allocatedSections * CoeffsPerSection };
+    std::copy(targetCoeffs.begin(), targetCoeffs.begin() + numCoeffs, coeffs.begin());
+    std::fill(coeffSteps.begin(), coeffSteps.begin() + numCoeffs, 0.f);
+}
+
+template<BiquadTopology Topology, typename Real>
+bool BiquadCascade<Topology, Real>::updateSectionStatus(unsigned int section, unsigned int interpolationSamples)
+{
+    const unsigned int o { section * CoeffsPerSection };
+    std::array<Real, CoeffsPerSection> c;
+    std::copy(targetCoeffs.begin() + o, targetCoeffs.begin() + o + CoeffsPerSection, c.begin());
+
+    // A section turning into an identity keeps running until the transient left
+    // by its previous coeffs has decayed, so no ringing is cut short
+    // With numerator equal to denominator the transient follows the poles of the
+    // coeffs, it is only drained for the slowest of the current and target poles
+    // A bypassed section resumes from the cleared states left by the drain
+    const SectionStatus oldStatus { sectionStatus[section] };
+    if (!isIdentity(c))
+    {
+        sectionStatus[section] = Active;
+    }
+    else if (oldStatus != Bypassed)
+    {
+        const unsigned int decaySamples { std::max(getDecaySamples(coeffs.data() + o), getDecaySamples(c.data())) };
+        const unsigned int newDrainSamples { std::min(decaySamples, MaxDrainSamples) + interpolationSamples };
+        drainSamples[section] = oldStatus == Draining ? std::max(drainSamples[section], newDrainSamples) : newDrainSamples;
+        sectionStatus[section] = Draining;
+    }
+
+    return sectionStatus[section] != oldStatus;
+}
+
+template<BiquadTopology Topology, typename Real>
+unsigned int BiquadCascade<Topology, Real>::getDecaySamples(const Real* c) noexcept
+{
+    // Largest radius of the roots of z^2 + a1 z + a2
+    const double a1 { static_cast<double>(c[3]) };
+    const double a2 { static_cast<double>(c[4]) };
+    const double discriminant { a1 * a1 - 4.0 * a2 };
+    const double radius { discriminant < 0.0 ? std::sqrt(a2) : 0.5 * (std::fabs(a1) + std::sqrt(discriminant)) };
+
+    // Poles on or outside the unit circle never decay, this also catches NaN coeffs
+    if (!(radius < 1.0))
+        return MaxDrainSamples;
+
+    // Poles at the origin leave only the states
+    if (radius <= 0.0)
+        return 2;
+
+    // radius^n = 1e-6
+    const double decaySamples { std::ceil(std::log(1e-6) / std::log(radius)) };
+    return static_cast<unsigned int>(std::min(decaySamples, static_cast<double>(MaxDrainSamples))) + 2;
+}
+
+template<BiquadTopology Topology, typename Real>
+bool BiquadCascade<Topology, Real>::isIdentity(const std::array<Real, CoeffsPerSection>& c) noexcept
+{
+    // Numerator equal to denominator, within a few ulps so the designs
+    // with unity gain (e.g. peak and shelves at 0 dB) are also caught
+    const Real tolerance { 4 * std::numeric_limits<Real>::epsilon() };
+    return std::fabs(c[0] - 1.f) <= tolerance
+        && std::fabs(c[1] - c[3]) <= tolerance
+        && std::fabs(c[2] - c[4]) <= tolerance;
 }
 
-void Biquad::setSectionCoeffs(const std::array<float, CoeffsPerSection>& newSectionCoeffs, unsigned int section)
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::resetSectionStatus()
 {
-    if (section < allocatedSections)
-        std::copy(newSectionCoeffs.begin(), newSectionCoeffs.end(), coeffs.begin() + (section * CoeffsPerSection));
+    for (unsigned int s = 0; s < reservedSections; ++s)
+    {
+        std::array<Real, CoeffsPerSection> c;
+        std::copy(coeffs.begin() + (s * CoeffsPerSection), coeffs.begin() + ((s + 1) * CoeffsPerSection), c.begin());
+        sectionStatus[s] = isIdentity(c) ? Bypassed : Active;
+    }
+
+    updateActiveSections();
 }
 
-void Biquad::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::updateActiveSections()
+{
+    numActiveSections = 0;
+    numDrainingSections = 0;
+    for (unsigned int s = 0; s < allocatedSections; ++s)
+    {
+        if (sectionStatus[s] != Bypassed)
+            activeSections[numActiveSections++] = s;
+
+        if (sectionStatus[s] == Draining)
+            ++numDrainingSections;
+    }
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::updateDrainingSections(unsigned int numSamples)
+{
+    bool changed { false };
+    for (unsigned int s = 0; s < allocatedSections; ++s)
+    {
+        if (sectionStatus[s] != Draining)
+            continue;
+
+        if (drainSamples[s] > numSamples)
+        {
+            drainSamples[s] -= numSamples;
+            continue;
+        }
+
+        // The transient has decayed, what is left is the rounding of the identity,
+        // the output of the cascade is the same whether it is processed or not
+        for (unsigned int c = 0; c < reservedChannels; ++c)
+            clearStates(c, s);
+
+        sectionStatus[s] = Bypassed;
+        changed = true;
+    }
+
+    if (changed)
+        updateActiveSections();
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    processSamples(output, input, numChannels, numSamples);
+}
+
+template<BiquadTopology Topology, typename Real>
+void BiquadCascade<Topology, Real>::process(double* const* output, const double* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    processSamples(output, input, numChannels, numSamples);
+}
+
+template<BiquadTopology Topology, typename Real>
+template<typename Sample>
+void BiquadCascade<Topology, Real>::processSamples(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples)
 {
     numChannels = std::min(numChannels, allocatedChannels);
-    for (unsigned int c = 0; c < numChannels; ++c)
+
+    // Blocks without new coeffs run the kernels with constant coeffs
+    if (numSamples > 0 && fetchPublishedCoeffs(numSamples))
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        processChannels<true>(output, input, numChannels, numSamples);
+        finishInterpolation();
+    }
+    else
+    {
+        processChannels<false>(output, input, numChannels, numSamples);
+    }
+
+    interpolateCoeffs = true;
+
+    if (numDrainingSections > 0)
+        updateDrainingSections(numSamples);
+}
+
+template<BiquadTopology Topology, typename Real>
+template<bool Interpolate, typename Sample>
+void BiquadCascade<Topology, Real>::processChannels(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    // Full channel groups go thru the vectorised kernel
+    // and the channels left over thru the scalar tail
+    const unsigned int numLaneChannels { (numChannels / LaneWidth) * LaneWidth };
+    if (strategy == SectionMajor)
+    {
+        for (unsigned int c = 0; c < numLaneChannels; c += LaneWidth)
+            processLanesSectionMajor<LaneWidth, Interpolate>(output, input, c, numSamples);
+
+        for (unsigned int c = numLaneChannels; c < numChannels; ++c)
+            processLanesSectionMajor<1, Interpolate>(output, input, c, numSamples);
+    }
+    else
+    {
+        for (unsigned int c = 0; c < numLaneChannels; c += LaneWidth)
+            processLanes<LaneWidth, Interpolate>(output, input, c, numSamples);
+
+        for (unsigned int c = numLaneChannels; c < numChannels; ++c)
+            processLanes<1, Interpolate>(output, input, c, numSamples);
+    }
+}
+
+template<BiquadTopology Topology, typename Real>
+template<unsigned int Width, bool Interpolate, typename Sample>
+void BiquadCascade<Topology, Real>::processLanes(Sample* const* output, const Sample* const* input, unsigned int firstChannel, unsigned int numSamples)
+{
+    static_assert(Width == 1 || Width == LaneWidth, "Lanes are either a full channel group or a single channel.");
+
+    Real* groupStates { states.data() + getStateOffset(firstChannel, 0) };
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        Real x[Width];
+        for (unsigned int l = 0; l < Width; ++l)
+            x[l] = static_cast<Real>(input[firstChannel + l][n]);
+
+        for (unsigned int i = 0; i < numActiveSections; ++i)
+        {
+            const unsigned int s { activeSections[i] };
+            Real* sectionStates { groupStates + s * StatesPerSection * LaneWidth };
+
+            // Constant coefficients are read in place, a local copy for every sample
+            // and section kept GCC from vectorising the Transposed Direct Form II lanes
+            Real interpolated[CoeffsPerSection];
+            const Real* c { coeffs.data() + s * CoeffsPerSection };
+            if constexpr (Interpolate)
+            {
+                loadSectionCoeffs<true>(interpolated, s, n);
+                c = interpolated;
+            }
+
+            // Load the lanes into locals so the lane loop is free of aliasing
+            Real st[StatesPerSection][Width];
+            for (unsigned int k = 0; k < StatesPerSection; ++k)
+                for (unsigned int l = 0; l < Width; ++l)
+                    st[k][l] = sectionStates[k * LaneWidth + l];
+
+            processSection<Width>(x, c, st);
+
+            for (unsigned int k = 0; k < StatesPerSection; ++k)
+                for (unsigned int l = 0; l < Width; ++l)
+                    sectionStates[k * LaneWidth + l] = st[k][l];
+        }
+
+        for (unsigned int l = 0; l < Width; ++l)
+            output[firstChannel + l][n] = static_cast<Sample>(x[l]);
+    }
+}
+
+template<BiquadTopology Topology, typename Real>
+template<unsigned int Width, bool Interpolate, typename Sample>
+void BiquadCascade<Topology, Real>::processLanesSectionMajor(Sample* const* output, const Sample* const* input, unsigned int firstChannel, unsigned int numSamples)
+{
+    static_assert(Width == 1 || Width == LaneWidth, "Lanes are either a full channel group or a single channel.");
+
+    Real* groupStates { states.data() + getStateOffset(firstChannel, 0) };
+
+    // The block is split in chunks that are gathered into a lane-interleaved
+    // scratch buffer on the stack, all sections then run over the chunk in-place
+    Real chunk[SectionMajorChunkSize][Width];
+
+    for (unsigned int n0 = 0; n0 < numSamples; n0 += SectionMajorChunkSize)
+    {
+        const unsigned int chunkSize { std::min(numSamples - n0, SectionMajorChunkSize) };
+
+        for (unsigned int n = 0; n < chunkSize; ++n)
+            for (unsigned int l = 0; l < Width; ++l)
+                chunk[n][l] = static_cast<Real>(input[firstChannel + l][n0 + n]);
+
+        for (unsigned int i = 0; i < numActiveSections; ++i)
         {
-            float x { input[c][n] };
-            for (unsigned int s = 0; s < allocatedSections; ++s)
+            const unsigned int s { activeSections[i] };
+            Real* sectionStates { groupStates + s * StatesPerSection * LaneWidth };
+
+            // Coefficients and states stay in locals for the whole chunk,
+            // unless the coefficients are interpolated
+            Real c[CoeffsPerSection];
+            loadSectionCoeffs<false>(c, s, 0);
+
+            Real st[StatesPerSection][Width];
+            for (unsigned int k = 0; k < StatesPerSection; ++k)
+                for (unsigned int l = 0; l < Width; ++l)
+                    st[k][l] = sectionStates[k * LaneWidth + l];
+
+            for (unsigned int n = 0; n < chunkSize; ++n)
             {
-                const unsigned int stateOffset { c * allocatedSections * StatesPerSection + s * StatesPerSection };
-                const unsigned int coeffOffset { s * CoeffsPerSection };
-
-                float acc { x * coeffs[coeffOffset + 0] }; // b0
-                acc += coeffs[coeffOffset + 1] * states[stateOffset + 0]; // b1
-                acc += coeffs[coeffOffset + 2] * states[stateOffset + 1]; // b2
-                acc -= coeffs[coeffOffset + 3] * states[stateOffset + 2]; // a1
-                acc -= coeffs[coeffOffset + 4] * states[stateOffset + 3]; // a2
-
-                states[stateOffset + 1] = states[stateOffset + 0];
-                states[stateOffset + 0] = x;
-                states[stateOffset + 3] = states[stateOffset + 2];
-                states[stateOffset + 2] = acc;
-                x = acc;
+                if constexpr (Interpolate)
+                    loadSectionCoeffs<true>(c, s, n0 + n);
+
+                processSection<Width>(chunk[n], c, st);
             }
-            output[c][n] = x;
+
+            for (unsigned int k = 0; k < StatesPerSection; ++k)
+                for (unsigned int l = 0; l < Width; ++l)
+                    sectionStates[k * LaneWidth + l] = st[k][l];
         }
+
+        for (unsigned int n = 0; n < chunkSize; ++n)
+            for (unsigned int l = 0; l < Width; ++l)
+                output[firstChannel + l][n0 + n] = static_cast<Sample>(chunk[n][l]);
     }
 }
 
+template class BiquadCascade<BiquadTopology::DirectFormI, float>;
+template class BiquadCascade<BiquadTopology::TransposedDirectFormII, float>;
+template class BiquadCascade<BiquadTopology::DirectFormI, double>;
+template class BiquadCascade<BiquadTopology::TransposedDirectFormII, double>;
+
 }
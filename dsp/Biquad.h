@@ -1,44 +1,128 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 namespace mrta
 {
 
-class Biquad
+// Realisation structure of the biquad sections
+// DirectFormI keeps the last two inputs and outputs of each section
+// TransposedDirectFormII keeps only two internal states, halving the state memory
+enum class BiquadTopology : unsigned int
+{
+    DirectFormI = 0,
+    TransposedDirectFormII
+};
+
+// Real is the type of the coefficients and states, process accepts float and double
+// audio in both cases, e.g. float audio with double states for low frequency filters
+// at high sample rates, or double throughout for double precision hosts
+template<BiquadTopology Topology, typename Real = float>
+class BiquadCascade
 {
 public:
-    Biquad(unsigned int numSections, unsigned int maxNumChannels);
-    Biquad();
-    ~Biquad();
+    BiquadCascade(unsigned int numSections, unsigned int maxNumChannels);
+    BiquadCascade();
+    ~BiquadCascade();
+
+    BiquadCascade(const BiquadCascade&);
+    const BiquadCascade& operator=(const BiquadCascade&);
 
-    Biquad(const Biquad&);
-    const Biquad& operator=(const Biquad&);
+    BiquadCascade(BiquadCascade&&) = delete;
+    const BiquadCascade& operator=(BiquadCascade&&) = delete;
 
-    Biquad(Biquad&&) = delete;
-    const Biquad& operator=(Biquad&&) = delete;
+    using CoeffType = Real;
 
     static const unsigned int CoeffsPerSection = 5;
-    static const unsigned int StatesPerSection = 4;
+    static const unsigned int StatesPerSection = Topology == BiquadTopology::DirectFormI ? 4 : 2;
+
+    // Number of channels processed together by the vectorised kernel
+    // Matches the Real lane count of the widest enabled instruction set
+#if defined(__AVX512F__)
+    static const unsigned int LaneWidth = 64 / sizeof(Real);
+#elif defined(__AVX__)
+    static const unsigned int LaneWidth = 32 / sizeof(Real);
+#else
+    static const unsigned int LaneWidth = 16 / sizeof(Real);
+#endif
+
+    // Loop order used to run the cascade over a block
+    enum ProcessingStrategy : unsigned int
+    {
+        // Every sample goes thru all sections before the next sample
+        // Best for short cascades and small blocks
+        SampleMajor = 0,
+
+        // Every section runs over the whole block before the next section
+        // Coefficients and states stay in registers for the whole block,
+        // best for long Direct Form I cascades (8+ sections)
+        SectionMajor
+    };
 
     // Clear all states
     void clear();
 
+    // Allocate storage for up to maxNumSections and maxNumChannels
+    // Coefficients of the sections kept are preserved, states are cleared
+    // The number of sections and channels in use is limited to the new capacity
+    void reserve(unsigned int maxNumSections, unsigned int maxNumChannels);
+
     // Reallocate state storage
+    // Only allocates if the channel count is above the reserved capacity
     // Calling this method will clear the states
     void reallocateChannels(unsigned int maxNumChannels);
 
     // Reallocate coefficient and state storage
+    // Only allocates if the section count is above the reserved capacity
     // Calling this method will clear the coefficients and states
     void reallocateSections(unsigned int numSections);
 
-    // Set new coeffs to a section
-    void setSectionCoeffs(const std::array<float, CoeffsPerSection>& newSectionCoeffs, unsigned int section);
+    // Change the number of sections in use, limited to the reserved capacity
+    // Never allocates so it can be called from the audio thread
+    // Sections coming into use start as a pass-thru with cleared states,
+    // the other sections keep their coefficients and states
+    void setNumSections(unsigned int numSections);
+
+    // Change the number of channels in use, limited to the reserved capacity
+    // Never allocates so it can be called from the audio thread
+    // Channels coming into use start from cleared states,
+    // the other channels keep their states
+    void setNumChannels(unsigned int numChannels);
+
+    // Set the loop order used by process, both produce the same output
+    void setProcessingStrategy(ProcessingStrategy newStrategy) noexcept { strategy = newStrategy; }
+
+    // return the current processing strategy
+    ProcessingStrategy getProcessingStrategy() const noexcept { return strategy; }
+
+    // Publish new target coeffs to a section
+    // Lock-free, it can be called from any thread while process runs on the audio thread
+    // The next call to process interpolates the coeffs linearly across its block,
+    // from the current coeffs to the targets. Coeffs published after the states
+    // have been cleared (e.g. before the first process) are applied without interpolation
+    // Coeffs published to a section before it comes into use are discarded
+    // Sections equal to an identity (e.g. flat bands or peaks at 0 dB) are
+    // skipped by process, once the states left from previous coeffs have decayed
+    void setSectionCoeffs(const std::array<Real, CoeffsPerSection>& newSectionCoeffs, unsigned int section);
+
+    // return the last coeffs set to a section, including the ones not yet fetched by process
+    // Must not be called concurrently with process
+    std::array<Real, CoeffsPerSection> getSectionCoeffs(unsigned int section) const;
+
+    // Check if the coeffs describe a pass-thru section
+    // Numerator equal to denominator, within a few ulps
+    static bool isIdentity(const std::array<Real, CoeffsPerSection>& c) noexcept;
 
     // Process audio
     // This method can be called with a lower number of channels than allocated
+    // Channels are processed LaneWidth at a time, the channels left over are
+    // processed one by one, both paths produce the same output as a
+    // channel by channel cascade (see processLanes)
     void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+    void process(double* const* output, const double* const* input, unsigned int numChannels, unsigned int numSamples);
 
     // return the number of currently allocated channels
     unsigned int getAllocatedChannels() const noexcept { return allocatedChannels; }
@@ -46,18 +130,226 @@ public:
     // return the number of currently allocated sections
     unsigned int getAllocatedSections() const noexcept { return allocatedSections; }
 
+    // return the number of sections process is currently running
+    unsigned int getActiveSections() const noexcept { return numActiveSections; }
+
+    // return the number of channels storage is reserved for
+    unsigned int getReservedChannels() const noexcept { return reservedChannels; }
+
+    // return the number of sections storage is reserved for
+    unsigned int getReservedSections() const noexcept { return reservedSections; }
+
 private:
+    // Implementation of both process overloads
+    template<typename Sample>
+    void processSamples(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Process Width channels starting at firstChannel in lanes
+    // Width is either LaneWidth for a full channel group or 1 for the leftover channels
+    // Interpolate is only set for the blocks where some section moves towards new targets
+    template<unsigned int Width, bool Interpolate, typename Sample>
+    void processLanes(Sample* const* output, const Sample* const* input, unsigned int firstChannel, unsigned int numSamples);
+
+    // Section-major flavour of processLanes
+    // The block is processed in chunks of up to SectionMajorChunkSize samples
+    template<unsigned int Width, bool Interpolate, typename Sample>
+    void processLanesSectionMajor(Sample* const* output, const Sample* const* input, unsigned int firstChannel, unsigned int numSamples);
+
+    // Dispatch the channel groups to the kernels of the current strategy
+    template<bool Interpolate, typename Sample>
+    void processChannels(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Load the coeffs of a section for sample n of the block
+    // When interpolating, the coeffs reach the targets on the last sample of the block
+    template<bool Interpolate>
+    inline void loadSectionCoeffs(Real (&c)[CoeffsPerSection], unsigned int section, unsigned int n) const noexcept
+    {
+        const Real* sectionCoeffs { coeffs.data() + section * CoeffsPerSection };
+        if constexpr (Interpolate)
+        {
+            const Real* sectionSteps { coeffSteps.data() + section * CoeffsPerSection };
+            const Real t { static_cast<Real>(n + 1) };
+            c[0] = sectionCoeffs[0] + t * sectionSteps[0];
+            c[1] = sectionCoeffs[1] + t * sectionSteps[1];
+            c[2] = sectionCoeffs[2] + t * sectionSteps[2];
+            c[3] = sectionCoeffs[3] + t * sectionSteps[3];
+            c[4] = sectionCoeffs[4] + t * sectionSteps[4];
+        }
+        else
+        {
+            c[0] = sectionCoeffs[0];
+            c[1] = sectionCoeffs[1];
+            c[2] = sectionCoeffs[2];
+            c[3] = sectionCoeffs[3];
+            c[4] = sectionCoeffs[4];
+        }
+    }
+
+    // Run one sample of a section on Width lanes
+    // Every lane runs exactly the same sequence of operations as a channel by
+    // channel cascade, so the vectorised and scalar paths are bit identical as long
+    // as the compiler does not contract the multiply-adds into FMAs differently for
+    // each path. With FP contraction enabled (e.g. -ffp-contract=fast with FMA
+    // available) the outputs may differ by rounding only, which stays below
+    // 1e-6 relative error per section for stable filters.
+    template<unsigned int Width>
+    static inline void processSection(Real (&x)[Width], const Real* c, Real (&st)[StatesPerSection][Width])
+    {
+        if constexpr (Topology == BiquadTopology::DirectFormI)
+        {
+            for (unsigned int l = 0; l < Width; ++l)
+            {
+                Real acc { x[l] * c[0] }; // b0
+                acc += c[1] * st[0][l]; // b1 * bz1
+                acc += c[2] * st[1][l]; // b2 * bz2
+                acc -= c[3] * st[2][l]; // a1 * az1
+                acc -= c[4] * st[3][l]; // a2 * az2
+
+                st[1][l] = st[0][l];
+                st[0][l] = x[l];
+                st[3][l] = st[2][l];
+                st[2][l] = acc;
+                x[l] = acc;
+            }
+        }
+        else
+        {
+            for (unsigned int l = 0; l < Width; ++l)
+            {
+                const Real y { x[l] * c[0] + st[0][l] };
+                st[0][l] = x[l] * c[1] - y * c[3] + st[1][l];
+                st[1][l] = x[l] * c[2] - y * c[4];
+                x[l] = y;
+            }
+        }
+    }
+
+    // Clear the states of one channel and section
+    void clearStates(unsigned int channel, unsigned int section);
+
+    // Processing status of a section
+    enum SectionStatus : unsigned char
+    {
+        // Section is processed
+        Active = 0,
+
+        // Section is an identity but its states are still decaying, so it is processed
+        Draining,
+
+        // Section is an identity with cleared states and is skipped
+        Bypassed
+    };
+
+    // Update the status of a section after new target coeffs
+    // interpolationSamples is the length of the block moving the coeffs to the targets, if any
+    // return true if the status changed
+    bool updateSectionStatus(unsigned int section, unsigned int interpolationSamples);
+
+    // Read the coeffs published since the last block into the targets
+    // and set up the interpolation towards them over numSamples
+    // return true if any section has to be interpolated in this block
+    bool fetchPublishedCoeffs(unsigned int numSamples);
+
+    // Set the current coeffs to the targets at the end of an interpolated block
+    void finishInterpolation();
+
+    // Sync the targets and published coeffs to the current coeffs,
+    // discarding anything published before
+    void resetPublishedCoeffs();
+
+    // Recompute the status of all sections from their coeffs, without draining
+    void resetSectionStatus();
+
+    // Rebuild the list of sections to process
+    void updateActiveSections();
+
+    // Count down the drain of the draining sections by a block of numSamples,
+    // and bypass the ones whose transient has decayed
+    void updateDrainingSections(unsigned int numSamples);
+
+    // Number of samples the transient of a section with the coeffs c takes to decay by 120 dB,
+    // from the radius of its poles, plus the two samples held in its states
+    static unsigned int getDecaySamples(const Real* c) noexcept;
+
+    // Drain length of sections whose poles never decay, about 20 s at 48 kHz
+    static constexpr unsigned int MaxDrainSamples { 1u << 20 };
+
+    // Number of channel groups of LaneWidth channels needed for the reserved channels
+    unsigned int getNumChannelGroups() const noexcept { return (reservedChannels + LaneWidth - 1) / LaneWidth; }
+
+    // Offset of the first state of a channel and section in the states vector
+    // The layout only depends on the reserved capacity, so changing the number
+    // of channels or sections in use does not move any state
+    unsigned int getStateOffset(unsigned int channel, unsigned int section) const noexcept
+    {
+        return ((channel / LaneWidth) * reservedSections + section) * StatesPerSection * LaneWidth + (channel % LaneWidth);
+    }
+
+    // Number of channels and sections in use
     unsigned int allocatedChannels { 0 };
     unsigned int allocatedSections { 0 };
 
-    // vector of coeffs of all sections
+    // Number of channels and sections storage is reserved for
+    unsigned int reservedChannels { 0 };
+    unsigned int reservedSections { 0 };
+
+    ProcessingStrategy strategy { SampleMajor };
+
+    static constexpr unsigned int SectionMajorChunkSize { 64 };
+
+    // status of all reserved sections
+    std::vector<SectionStatus> sectionStatus;
+
+    // indices of the sections that process runs, only the first numActiveSections are valid
+    std::vector<unsigned int> activeSections;
+    unsigned int numActiveSections { 0 };
+    unsigned int numDrainingSections { 0 };
+
+    // samples left before each draining section is bypassed
+    std::vector<unsigned int> drainSamples;
+
+    // vector of coeffs of all reserved sections at the start of the block
     // [sos0_b0, sos0_b1, sos0_b2, sos0_a1, sos0_a2, sos1_b0, sos1_b1, ...]
-    std::vector<float> coeffs;
+    std::vector<Real> coeffs;
+
+    // target coeffs and per sample increments towards them, same layout as coeffs
+    // Linear interpolation keeps every section stable, since the set of stable
+    // (a1, a2) pairs is convex
+    std::vector<Real> targetCoeffs;
+    std::vector<Real> coeffSteps;
 
-    // vector of states of all channels and sections
-    // [ch0_sos0_bz1, ... , ch0_sos0_az2, ch0_sos1_bz1, ... , ch0_sos1_az2, ... ,
-    //  ch1_sos0_bz1, ... , ch1_sos0_az2, ch1_sos1_bz1, ... , ch1_sos1_az2, ...]
-    std::vector<float> states;
+    // Coeffs published by setSectionCoeffs, same layout as coeffs
+    // Every section is guarded by a sequence counter, odd while a publisher is writing
+    // The audio thread only reads a section if its counter is even and
+    // unchanged across the read, so it never waits on a publisher
+    std::unique_ptr<std::atomic<Real>[]> publishedCoeffs;
+    std::unique_ptr<std::atomic<unsigned int>[]> publishedSequence;
+
+    // Number of completed publications, lets process skip the sections scan
+    // when nothing was published since the last block
+    std::atomic<unsigned int> publishCount { 0 };
+
+    // Audio thread copies of the counters above at the last fetch
+    std::vector<unsigned int> fetchedSequence;
+    unsigned int fetchedPublishCount { 0 };
+
+    // Cleared along with the states, the first coeffs fetched afterwards are applied directly
+    bool interpolateCoeffs { false };
+
+    // vector of states of all reserved channels and sections
+    // channels are grouped by LaneWidth and the states of a group are lane-interleaved,
+    // so the same state of all channels in a group is contiguous (L = LaneWidth - 1)
+    // [g0_sos0_bz1_ch0, ... , g0_sos0_bz1_chL, g0_sos0_bz2_ch0, ... , g0_sos0_az2_chL,
+    //  g0_sos1_bz1_ch0, ... , g0_sos1_az2_chL, ... ,
+    //  g1_sos0_bz1_ch0, ... , g1_sos0_az2_chL, g1_sos1_bz1_ch0, ... , g1_sos1_az2_chL, ...]
+    // the TransposedDirectFormII topology stores s1 and s2 in place of bz1 ... az2
+    std::vector<Real> states;
 };
 
+// Direct Form I cascade
+using Biquad = BiquadCascade<BiquadTopology::DirectFormI>;
+
+// Transposed Direct Form II cascade
+using BiquadTDF2 = BiquadCascade<BiquadTopology::TransposedDirectFormII>;
+
 }
@@ -0,0 +1,154 @@
+#include "BiquadBank.h"
+
+#include <algorithm>
+
+namespace mrta
+{
+
+BiquadBank::BiquadBank(unsigned int numFilters)
+{
+    reallocateFilters(numFilters);
+}
+
+BiquadBank::BiquadBank()
+{
+}
+
+BiquadBank::~BiquadBank()
+{
+}
+
+void BiquadBank::clear()
+{
+    for (auto& s : states)
+        std::fill(s.begin(), s.end(), 0.f);
+}
+
+void BiquadBank::reallocateFilters(unsigned int numFilters)
+{
+    allocatedFilters = numFilters;
+
+    for (auto& c : coeffs)
+        c.assign(allocatedFilters, 0.f);
+
+    for (auto& s : states)
+        s.assign(allocatedFilters, 0.f);
+}
+
+void BiquadBank::setFilterCoeffs(const std::array<float, CoeffsPerSection>& newFilterCoeffs, unsigned int filter)
+{
+    if (filter < allocatedFilters)
+        for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+            coeffs[k][filter] = newFilterCoeffs[k];
+}
+
+void BiquadBank::process(float* const* output, const float* const* input, unsigned int numFilters, unsigned int numSamples)
+{
+    numFilters = std::min(numFilters, allocatedFilters);
+
+    // Full groups of filters go thru the vectorised kernel
+    // and the filters left over thru the scalar tail
+    const unsigned int numLaneFilters { (numFilters / LaneWidth) * LaneWidth };
+    for (unsigned int f = 0; f < numLaneFilters; f += LaneWidth)
+        processLanes<LaneWidth>(output, input, f, numSamples);
+
+    for (unsigned int f = numLaneFilters; f < numFilters; ++f)
+        processLanes<1>(output, input, f, numSamples);
+}
+
+void BiquadBank::processInterleaved(float* output, const float* input, unsigned int numFilters, unsigned int numSamples)
+{
+    // The frame stride is the caller's filter count, even if more are allocated
+    const unsigned int frameSize { numFilters };
+    numFilters = std::min(numFilters, allocatedFilters);
+
+    // The block is split in chunks of frames, so the frames a group of filters
+    // touches are still in cache when the next group reads the same cache lines
+    const unsigned int numLaneFilters { (numFilters / LaneWidth) * LaneWidth };
+    for (unsigned int n0 = 0; n0 < numSamples; n0 += InterleavedChunkSize)
+    {
+        const unsigned int chunkSize { std::min(numSamples - n0, InterleavedChunkSize) };
+        float* chunkOutput { output + n0 * frameSize };
+        const float* chunkInput { input + n0 * frameSize };
+
+        for (unsigned int f = 0; f < numLaneFilters; f += LaneWidth)
+            processLanesInterleaved<LaneWidth>(chunkOutput, chunkInput, f, frameSize, chunkSize);
+
+        for (unsigned int f = numLaneFilters; f < numFilters; ++f)
+            processLanesInterleaved<1>(chunkOutput, chunkInput, f, frameSize, chunkSize);
+    }
+}
+
+template<unsigned int Width>
+void BiquadBank::processLanes(float* const* output, const float* const* input, unsigned int firstFilter, unsigned int numSamples)
+{
+    // Coefficients and states of the group stay in locals for the whole block
+    float c[CoeffsPerSection][Width];
+    for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+        for (unsigned int l = 0; l < Width; ++l)
+            c[k][l] = coeffs[k][firstFilter + l];
+
+    float st[Biquad::StatesPerSection][Width];
+    for (unsigned int k = 0; k < Biquad::StatesPerSection; ++k)
+        for (unsigned int l = 0; l < Width; ++l)
+            st[k][l] = states[k][firstFilter + l];
+
+    // Local copies of the channel pointers, so they are not reloaded after every store
+    const float* in[Width];
+    float* out[Width];
+    for (unsigned int l = 0; l < Width; ++l)
+    {
+        in[l] = input[firstFilter + l];
+        out[l] = output[firstFilter + l];
+    }
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        float x[Width];
+        for (unsigned int l = 0; l < Width; ++l)
+            x[l] = in[l][n];
+
+        processStep<Width>(x, c, st);
+
+        for (unsigned int l = 0; l < Width; ++l)
+            out[l][n] = x[l];
+    }
+
+    for (unsigned int k = 0; k < Biquad::StatesPerSection; ++k)
+        for (unsigned int l = 0; l < Width; ++l)
+            states[k][firstFilter + l] = st[k][l];
+}
+
+template<unsigned int Width>
+void BiquadBank::processLanesInterleaved(float* output, const float* input, unsigned int firstFilter, unsigned int frameSize, unsigned int numSamples)
+{
+    float c[CoeffsPerSection][Width];
+    for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+        for (unsigned int l = 0; l < Width; ++l)
+            c[k][l] = coeffs[k][firstFilter + l];
+
+    float st[Biquad::StatesPerSection][Width];
+    for (unsigned int k = 0; k < Biquad::StatesPerSection; ++k)
+        for (unsigned int l = 0; l < Width; ++l)
+            st[k][l] = states[k][firstFilter + l];
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const unsigned int frameOffset { n * frameSize + firstFilter };
+
+        float x[Width];
+        for (unsigned int l = 0; l < Width; ++l)
+            x[l] = input[frameOffset + l];
+
+        processStep<Width>(x, c, st);
+
+        for (unsigned int l = 0; l < Width; ++l)
+            output[frameOffset + l] = x[l];
+    }
+
+    for (unsigned int k = 0; k < Biquad::StatesPerSection; ++k)
+        for (unsigned int l = 0; l < Width; ++l)
+            states[k][firstFilter + l] = st[k][l];
+}
+
+}
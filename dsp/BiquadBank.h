@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Biquad.h"
+
+#include <array>
+#include <vector>
+
+namespace mrta
+{
+
+// Bank of independent single section biquad filters, each one with its own
+// coefficients, states and mono audio stream
+// Coefficients and states are stored as structure of arrays, so LaneWidth
+// filters are processed together in one vectorised step
+class BiquadBank
+{
+public:
+    static const unsigned int CoeffsPerSection = Biquad::CoeffsPerSection;
+    static const unsigned int LaneWidth = Biquad::LaneWidth;
+
+    BiquadBank(unsigned int numFilters);
+    BiquadBank();
+    ~BiquadBank();
+
+    // No copy semantics
+    BiquadBank(const BiquadBank&) = delete;
+    const BiquadBank& operator=(const BiquadBank&) = delete;
+
+    // No move semantics
+    BiquadBank(BiquadBank&&) = delete;
+    const BiquadBank& operator=(BiquadBank&&) = delete;
+
+    // Clear all states
+    void clear();
+
+    // Reallocate coefficient and state storage
+    // Calling this method will clear the coefficients and states
+    void reallocateFilters(unsigned int numFilters);
+
+    // Set new coeffs to a filter, same convention as Biquad::setSectionCoeffs
+    // [b0, b1, b2, a1, a2]
+    void setFilterCoeffs(const std::array<float, CoeffsPerSection>& newFilterCoeffs, unsigned int filter);
+
+    // Process audio, filter f reads from input[f] and writes to output[f]
+    // This method can be called with a lower number of filters than allocated
+    void process(float* const* output, const float* const* input, unsigned int numFilters, unsigned int numSamples);
+
+    // Process frame-interleaved audio, sample n of filter f is at [n * numFilters + f]
+    // in both input and output, which lets every lane load and store contiguously
+    // This method can be called with a lower number of filters than allocated
+    void processInterleaved(float* output, const float* input, unsigned int numFilters, unsigned int numSamples);
+
+    // return the number of currently allocated filters
+    unsigned int getAllocatedFilters() const noexcept { return allocatedFilters; }
+
+private:
+    // Process Width filters starting at firstFilter
+    // Width is either LaneWidth for a full group of filters or 1 for the leftover filters
+    template<unsigned int Width>
+    void processLanes(float* const* output, const float* const* input, unsigned int firstFilter, unsigned int numSamples);
+
+    // Frame-interleaved flavour of processLanes
+    template<unsigned int Width>
+    void processLanesInterleaved(float* output, const float* input, unsigned int firstFilter, unsigned int frameSize, unsigned int numSamples);
+
+    // Run one sample of Width filters, coefficients and states are per lane
+    // Same operation order as mrta::Biquad, so a single section
+    // Biquad and a filter of the bank produce the same output
+    template<unsigned int Width>
+    static inline void processStep(float (&x)[Width], const float (&c)[CoeffsPerSection][Width], float (&st)[Biquad::StatesPerSection][Width])
+    {
+        for (unsigned int l = 0; l < Width; ++l)
+        {
+            float acc { x[l] * c[0][l] };
+            acc += c[1][l] * st[0][l];
+            acc += c[2][l] * st[1][l];
+            acc -= c[3][l] * st[2][l];
+            acc -= c[4][l] * st[3][l];
+
+            st[1][l] = st[0][l];
+            st[0][l] = x[l];
+            st[3][l] = st[2][l];
+            st[2][l] = acc;
+            x[l] = acc;
+        }
+    }
+
+    // Number of frames processInterleaved runs per group of filters before moving on
+    static constexpr unsigned int InterleavedChunkSize { 32 };
+
+    unsigned int allocatedFilters { 0 };
+
+    // Coefficients of all filters, one vector per coefficient
+    // [f0_b0, f1_b0, f2_b0, ...], [f0_b1, f1_b1, ...], ...
+    std::array<std::vector<float>, CoeffsPerSection> coeffs;
+
+    // Direct Form I states of all filters, one vector per state
+    // [f0_bz1, f1_bz1, f2_bz1, ...], [f0_bz2, f1_bz2, ...], [f0_az1, ...], [f0_az2, ...]
+    std::array<std::vector<float>, Biquad::StatesPerSection> states;
+};
+
+}
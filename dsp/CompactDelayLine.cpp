@@ -0,0 +1,219 @@
+#include "CompactDelayLine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mrta
+{
+
+template<typename Format>
+CompactDelayLine<Format>::CompactDelayLine(unsigned int newMaxLengthSamples, unsigned int numChannels) :
+    maxLengthSamples { newMaxLengthSamples }
+{
+    allocate(numChannels);
+}
+
+template<typename Format>
+CompactDelayLine<Format>::~CompactDelayLine()
+{
+}
+
+template<typename Format>
+void CompactDelayLine<Format>::clear()
+{
+    std::fill(delayBuffer.get(), delayBuffer.get() + allocatedSize, Format::encode(0.f));
+}
+
+template<typename Format>
+void CompactDelayLine<Format>::prepare(unsigned int newMaxLengthSamples, unsigned int numChannels)
+{
+    maxLengthSamples = newMaxLengthSamples;
+    allocate(numChannels);
+}
+
+template<typename Format>
+void CompactDelayLine<Format>::allocate(unsigned int numChannels)
+{
+    bufferSize = maxLengthSamples + HistorySamples;
+
+    const unsigned int alignedSamples { static_cast<unsigned int>(Alignment / sizeof(SampleType)) };
+    channelStride = ((bufferSize + GuardSamples + alignedSamples - 1) / alignedSamples) * alignedSamples;
+
+    // Keep the current storage if it is large enough
+    const std::size_t requiredSize { static_cast<std::size_t>(channelStride) * numChannels };
+    if (requiredSize > allocatedSize)
+    {
+        delayBuffer.reset(static_cast<SampleType*>(::operator new[](requiredSize * sizeof(SampleType), std::align_val_t { Alignment })));
+        allocatedSize = requiredSize;
+    }
+
+    numAllocatedChannels = numChannels;
+    writeIndex = 0;
+    clear();
+}
+
+template<typename Format>
+template<typename Interpolation>
+void CompactDelayLine<Format>::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    static_assert(!Interpolation::IsRecursive, "Compact delay reads need a non recursive interpolation");
+
+    const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+
+    // The newest sample read must be older than the current sample
+    const float delay { std::fmax(delaySamples, static_cast<float>(Interpolation::NumNewerTaps + 1)) };
+    const unsigned int delayInt { static_cast<unsigned int>(delay) };
+    const float delayFrac { delay - static_cast<float>(delayInt) };
+
+    // Chunks are never longer than the delay, minus the newer samples the interpolation reads,
+    // so a chunk only reads samples written before it
+    const unsigned int maxChunkSize { std::min(ChunkSize, delayInt - Interpolation::NumNewerTaps) };
+
+    float x[ChunkSize];
+    float y[ChunkSize];
+    float decoded[ChunkSize + HistorySamples];
+
+    numChannels = std::min(numChannels, numAllocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        unsigned int workingWriteIndex { writeIndex };
+
+        for (unsigned int n0 = 0; n0 < numSamples; n0 += maxChunkSize)
+        {
+            const unsigned int chunkSize { std::min(numSamples - n0, maxChunkSize) };
+
+            // Keep the input of the chunk, the output can be the same buffer
+            std::copy(input[ch] + n0, input[ch] + n0 + chunkSize, x);
+
+            if (delayFrac == 0.f)
+            {
+                read(y, ch, wrap(workingWriteIndex + bufferSize - delayInt), chunkSize);
+            }
+            else
+            {
+                // Decode the taps of the whole chunk, from the oldest tap of its first sample
+                read(decoded, ch, wrap(workingWriteIndex + bufferSize - delayInt - olderTaps), chunkSize + Interpolation::NumTaps - 1);
+
+                float state { 0.f };
+                for (unsigned int n = 0; n < chunkSize; ++n)
+                    y[n] = Interpolation::interpolate(decoded + n, 1u, delayFrac, state);
+            }
+
+            write(ch, workingWriteIndex, x, chunkSize);
+            workingWriteIndex = wrap(workingWriteIndex + chunkSize);
+
+            std::copy(y, y + chunkSize, output[ch] + n0);
+        }
+    }
+
+    writeIndex = (writeIndex + numSamples) % bufferSize;
+}
+
+template<typename Format>
+template<typename Interpolation>
+void CompactDelayLine<Format>::process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    static_assert(!Interpolation::IsRecursive, "Compact delay reads need a non recursive interpolation");
+
+    const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+
+    // The newest sample read must be older than the current sample
+    const float delay { std::fmax(delaySamples, static_cast<float>(Interpolation::NumNewerTaps + 1)) };
+    const unsigned int delayInt { static_cast<unsigned int>(delay) };
+    const float delayFrac { delay - static_cast<float>(delayInt) };
+
+    // The modulation only lengthens the delay, so chunks no longer than the set delay,
+    // minus the newer samples the interpolation reads, only read samples written before them
+    const unsigned int maxChunkSize { std::min(ModulatedChunkSize, delayInt - Interpolation::NumNewerTaps) };
+
+    // Largest modulation, so the integer delay stays below maxLengthSamples
+    const float maxModulation { static_cast<float>(std::max(maxLengthSamples, delayInt + 1u) - 1u - delayInt) };
+
+    float x[ModulatedChunkSize];
+    float y[ModulatedChunkSize];
+    float frac[ModulatedChunkSize];
+    unsigned int oldestTap[ModulatedChunkSize];
+    SampleType taps[Interpolation::NumTaps][ModulatedChunkSize];
+    float decoded[Interpolation::NumTaps][ModulatedChunkSize];
+
+    numChannels = std::min(numChannels, numAllocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        unsigned int workingWriteIndex { writeIndex };
+        const SampleType* samples { channel(ch) };
+
+        for (unsigned int n0 = 0; n0 < numSamples; n0 += maxChunkSize)
+        {
+            const unsigned int chunkSize { std::min(numSamples - n0, maxChunkSize) };
+
+            // Keep the input of the chunk, the output can be the same buffer
+            std::copy(audioInput[ch] + n0, audioInput[ch] + n0 + chunkSize, x);
+
+            // The lane loops always run over a whole chunk, so they vectorise without a remainder,
+            // lanes past the end of a short chunk read without modulation next to its last sample
+            float mod[ModulatedChunkSize] {};
+            std::copy(modInput[ch] + n0, modInput[ch] + n0 + chunkSize, mod);
+
+            // Split the modulation in integer and fractional delay, m is never negative, so truncation is the floor
+            // Oldest tap of every sample, the bounded delays need a single conditional wrap
+            for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+            {
+                const float clamped { mod[l] > 0.f ? (mod[l] < maxModulation ? mod[l] : maxModulation) : 0.f };
+                const float m { delayFrac + clamped };
+                const unsigned int mFloor { static_cast<unsigned int>(static_cast<int>(m)) };
+                frac[l] = m - static_cast<float>(mFloor);
+                oldestTap[l] = wrap(workingWriteIndex + std::min(l, chunkSize - 1) + bufferSize - delayInt - mFloor - olderTaps);
+            }
+
+            // Gather the encoded taps of every sample, tap k of sample l is at taps[k][l], then decode them all at once
+            // The newer taps can be in the guard zone
+            for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                for (unsigned int k = 0; k < Interpolation::NumTaps; ++k)
+                    taps[k][l] = samples[oldestTap[l] + k];
+
+            Format::decode(&decoded[0][0], &taps[0][0], Interpolation::NumTaps * ModulatedChunkSize);
+
+            float state { 0.f };
+            for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                y[l] = Interpolation::interpolate(&decoded[0][l], ModulatedChunkSize, frac[l], state);
+
+            write(ch, workingWriteIndex, x, chunkSize);
+            workingWriteIndex = wrap(workingWriteIndex + chunkSize);
+
+            std::copy(y, y + chunkSize, audioOutput[ch] + n0);
+        }
+    }
+
+    writeIndex = (writeIndex + numSamples) % bufferSize;
+}
+
+template<typename Format>
+void CompactDelayLine<Format>::setDelaySamples(float newDelaySamples)
+{
+    delaySamples = std::fmax(std::fmin(newDelaySamples, static_cast<float>(maxLengthSamples) - 1.f), 1.f);
+}
+
+template class CompactDelayLine<DelaySampleFormat::Int16>;
+template class CompactDelayLine<DelaySampleFormat::Half>;
+
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::Linear>(float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::Lagrange3>(float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::Hermite3>(float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, unsigned int, unsigned int);
+
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::Linear>(float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::Lagrange3>(float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::Hermite3>(float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, unsigned int, unsigned int);
+
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::Linear>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::Lagrange3>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::Hermite3>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Int16>::process<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::Linear>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::Lagrange3>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::Hermite3>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void CompactDelayLine<DelaySampleFormat::Half>::process<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+
+}
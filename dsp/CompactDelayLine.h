@@ -0,0 +1,147 @@
+#pragma once
+
+#include "DelayInterpolation.h"
+#include "DelaySampleFormat.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace mrta
+{
+
+// Delay line storing its samples in one of the compact DelaySampleFormat formats
+// Meant for multi second delays and loopers over many channels, where the float buffers of
+// DelayLine dominate the memory and the cache misses: the buffer takes half the memory
+// and half the bandwidth, at the noise floor of the format (see DelaySampleFormat)
+// Processing matches DelayLine with the Planar layout and the Modulo wrap mode, as padding
+// long buffers to a power of two would undo the savings, and delay changes jump
+// Reads decode the samples of a chunk into floats before interpolating them, and writes
+// encode a chunk of input at once, both in loops the compiler vectorises
+// The interpolation must not be recursive, as the reads do not keep a state
+template<typename Format>
+class CompactDelayLine
+{
+public:
+    using SampleType = typename Format::Type;
+
+    CompactDelayLine(unsigned int maxLengthSamples, unsigned int numChannels);
+    ~CompactDelayLine();
+
+    // No default ctor
+    CompactDelayLine() = delete;
+
+    // No copy semantics
+    CompactDelayLine(const CompactDelayLine&) = delete;
+    const CompactDelayLine& operator=(const CompactDelayLine&) = delete;
+
+    // No move semantics
+    CompactDelayLine(CompactDelayLine&&) = delete;
+    const CompactDelayLine& operator=(CompactDelayLine&&) = delete;
+
+    // Clear the contents of the delay buffer
+    void clear();
+
+    // Resize delay buffer for the new length and channel count and clear its contents
+    // The storage is only reallocated if it needs to grow
+    void prepare(unsigned int maxLengthSamples, unsigned int numChannels);
+
+    // Process audio with the currently (fixed) set delay time
+    // Integer delays decode the delayed samples straight to the output,
+    // fractional delays read with the Interpolation policy
+    template<typename Interpolation = DelayInterpolation::Linear>
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Process audio thru the delay line with audio rate modulation
+    // The modulation input is a audio rate signal with the time modulation in samples
+    // on top of the currently set delay time, negative values are ignored and the
+    // modulated delay is limited to maxLengthSamples - 1
+    template<typename Interpolation = DelayInterpolation::Linear>
+    void process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
+                 unsigned int numChannels, unsigned int numSamples);
+
+    // Set the current delay time in samples, limited to [1, maxLengthSamples - 1]
+    // Policies with newer taps need that many samples of delay plus one, shorter delays are clamped
+    void setDelaySamples(float samples);
+
+    // return the current delay time in samples
+    float getDelaySamples() const noexcept { return delaySamples; }
+
+    // return the size of the delay buffer in bytes
+    std::size_t getBufferBytes() const noexcept { return allocatedSize * sizeof(SampleType); }
+
+private:
+    // Alignment of the delay buffer in bytes, a cache line, every channel starts on an aligned address
+    static constexpr std::size_t Alignment { 64 };
+
+    struct AlignedDeleter
+    {
+        void operator()(SampleType* p) const { ::operator delete[](p, std::align_val_t { Alignment }); }
+    };
+
+    // Samples kept beyond maxLengthSamples, for the older taps of the interpolation
+    static constexpr unsigned int HistorySamples { 16 };
+    static_assert(DelayInterpolation::WindowedSinc::NumTaps <= HistorySamples, "History too short for the interpolation taps");
+
+    // Every channel is followed by a guard zone mirroring its first GuardSamples samples,
+    // so the modulated reads gather the taps of a sample without wrapping
+    static constexpr unsigned int GuardSamples { 16 };
+    static_assert(DelayInterpolation::WindowedSinc::NumTaps <= GuardSamples + 1, "Guard zone too short for the interpolation taps");
+
+    // Number of samples processed per chunk, the decoded samples of a chunk live on the stack
+    static constexpr unsigned int ChunkSize { 64 };
+
+    // Number of samples the modulated processing reads at once
+    static constexpr unsigned int ModulatedChunkSize { 16 };
+
+    // Size the buffer of every channel for maxLengthSamples
+    void allocate(unsigned int numChannels);
+
+    // Start of the samples of channel ch
+    SampleType* channel(unsigned int ch) noexcept { return delayBuffer.get() + static_cast<std::size_t>(ch) * channelStride; }
+
+    // Decode count samples of channel ch from index on, wrapping around the end of the buffer
+    void read(float* output, unsigned int ch, unsigned int index, unsigned int count) noexcept
+    {
+        const unsigned int first { std::min(count, bufferSize - index) };
+        Format::decode(output, channel(ch) + index, first);
+        Format::decode(output + first, channel(ch), count - first);
+    }
+
+    // Encode count samples of channel ch from index on, wrapping around the end of the buffer,
+    // and mirror the ones written to the start of the buffer in the guard zone
+    void write(unsigned int ch, unsigned int index, const float* input, unsigned int count) noexcept
+    {
+        SampleType* samples { channel(ch) };
+        const unsigned int first { std::min(count, bufferSize - index) };
+        Format::encode(samples + index, input, first);
+        Format::encode(samples, input + first, count - first);
+
+        if (index < GuardSamples)
+            std::copy(samples + index, samples + std::min(index + count, GuardSamples), samples + bufferSize + index);
+
+        if (count > first)
+            std::copy(samples, samples + std::min(count - first, GuardSamples), samples + bufferSize);
+    }
+
+    // Wrap an index in [0, 2 * bufferSize) into [0, bufferSize)
+    unsigned int wrap(unsigned int index) const noexcept { return index >= bufferSize ? index - bufferSize : index; }
+
+    // All channels in one aligned allocation of allocatedSize samples
+    std::unique_ptr<SampleType[], AlignedDeleter> delayBuffer;
+    std::size_t allocatedSize { 0 };
+
+    unsigned int maxLengthSamples { 0 };
+    unsigned int numAllocatedChannels { 0 };
+
+    // Samples per channel, maxLengthSamples plus the history, and distance between neighbour channels,
+    // bufferSize plus the guard zone rounded up to the alignment
+    unsigned int bufferSize { 0 };
+    unsigned int channelStride { 0 };
+
+    float delaySamples { 1.f };
+    unsigned int writeIndex { 0 };
+};
+
+}
@@ -0,0 +1,53 @@
+#include "DelayInterpolation.h"
+
+#include <cmath>
+
+namespace mrta
+{
+namespace DelayInterpolation
+{
+
+namespace
+{
+
+struct WindowedSincTable
+{
+    float table[WindowedSinc::Phases + 1][WindowedSinc::NumTaps];
+
+    WindowedSincTable()
+    {
+        const double pi { std::acos(-1.0) };
+        const double halfWidth { 0.5 * WindowedSinc::NumTaps };
+        const double newestPosition { static_cast<double>(WindowedSinc::NumTaps - 1 - WindowedSinc::NumNewerTaps) };
+
+        for (unsigned int p = 0; p <= WindowedSinc::Phases; ++p)
+        {
+            const double frac { static_cast<double>(p) / WindowedSinc::Phases };
+
+            // Tap k is the sample at delay D + newestPosition - k, its distance to D + frac is u
+            double h[WindowedSinc::NumTaps];
+            double sum { 0.0 };
+            for (unsigned int k = 0; k < WindowedSinc::NumTaps; ++k)
+            {
+                const double u { newestPosition - k - frac };
+                const double sinc { std::fabs(u) < 1e-9 ? 1.0 : std::sin(pi * u) / (pi * u) };
+                const double window { std::fabs(u) < halfWidth ? 0.42 + 0.5 * std::cos(pi * u / halfWidth) + 0.08 * std::cos(2.0 * pi * u / halfWidth) : 0.0 };
+                h[k] = sinc * window;
+                sum += h[k];
+            }
+
+            // Unity gain at DC for every phase
+            for (unsigned int k = 0; k < WindowedSinc::NumTaps; ++k)
+                table[p][k] = static_cast<float>(h[k] / sum);
+        }
+    }
+};
+
+const WindowedSincTable windowedSincTable;
+
+}
+
+const float (&WindowedSinc::table)[WindowedSinc::Phases + 1][WindowedSinc::NumTaps] { windowedSincTable.table };
+
+}
+}
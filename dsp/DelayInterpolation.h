@@ -0,0 +1,137 @@
+#pragma once
+
+namespace mrta
+{
+
+// Fractional delay interpolation policies for the modulated DelayLine::process methods
+// A policy reads NumTaps consecutive samples around the integer part of the delay D,
+// NumNewerTaps of them are newer than the sample at delay D, the rest are older
+// interpolate gets a pointer to the oldest tap, tap k at x[k * stride], the fractional
+// part of the delay in [0, 1) and a per channel state, used only by recursive policies
+// (IsRecursive), the others can read any number of positions in any order
+// The taps are combined with a fixed size weighted sum, unrolled by the compiler
+namespace DelayInterpolation
+{
+
+// Linear interpolation between the samples at delays D and D + 1
+// Cheapest, but attenuates high frequencies for fractional delays close to 0.5
+struct Linear
+{
+    static constexpr unsigned int NumTaps { 2 };
+    static constexpr unsigned int NumNewerTaps { 0 };
+    static constexpr bool IsRecursive { false };
+
+    static inline float interpolate(const float* x, unsigned int stride, float frac, float& /*state*/) noexcept
+    {
+        return x[stride] * (1.f - frac) + x[0] * frac;
+    }
+};
+
+// Third order Lagrange interpolation over the samples at delays D - 1 to D + 2
+// Maximally flat at DC, much lower high frequency loss than Linear
+struct Lagrange3
+{
+    static constexpr unsigned int NumTaps { 4 };
+    static constexpr unsigned int NumNewerTaps { 1 };
+    static constexpr bool IsRecursive { false };
+
+    static inline float interpolate(const float* x, unsigned int stride, float frac, float& /*state*/) noexcept
+    {
+        const float d { frac };
+        const float dp1 { d + 1.f };
+        const float dm1 { d - 1.f };
+        const float dm2 { d - 2.f };
+
+        // Oldest tap first, the sample at delay D + 2
+        const float h[NumTaps] { dp1 * d * dm1 * (1.f / 6.f),
+                                 -dp1 * d * dm2 * 0.5f,
+                                 dp1 * dm1 * dm2 * 0.5f,
+                                 -d * dm1 * dm2 * (1.f / 6.f) };
+
+        float y { 0.f };
+        for (unsigned int k = 0; k < NumTaps; ++k)
+            y += h[k] * x[k * stride];
+
+        return y;
+    }
+};
+
+// Cubic Hermite (Catmull-Rom) interpolation over the samples at delays D - 1 to D + 2
+// Continuous first derivative, which keeps the modulation noise low
+struct Hermite3
+{
+    static constexpr unsigned int NumTaps { 4 };
+    static constexpr unsigned int NumNewerTaps { 1 };
+    static constexpr bool IsRecursive { false };
+
+    static inline float interpolate(const float* x, unsigned int stride, float frac, float& /*state*/) noexcept
+    {
+        const float y2 { x[0] };
+        const float y1 { x[stride] };
+        const float y0 { x[2 * stride] };
+        const float ym1 { x[3 * stride] };
+
+        const float c1 { 0.5f * (y1 - ym1) };
+        const float c2 { ym1 - 2.5f * y0 + 2.f * y1 - 0.5f * y2 };
+        const float c3 { 0.5f * (y2 - ym1) + 1.5f * (y0 - y1) };
+
+        return ((c3 * frac + c2) * frac + c1) * frac + y0;
+    }
+};
+
+// First order Thiran allpass interpolation
+// Flat magnitude response at all frequencies, but recursive, so sudden delay changes ring
+// The fractional delay is kept in [0.5, 1.5) by using the newer tap for small fractions,
+// which keeps the pole away from z = -1
+struct Thiran1
+{
+    static constexpr unsigned int NumTaps { 3 };
+    static constexpr unsigned int NumNewerTaps { 1 };
+    static constexpr bool IsRecursive { true };
+
+    static inline float interpolate(const float* x, unsigned int stride, float frac, float& state) noexcept
+    {
+        const bool shift { frac < 0.5f };
+        const float delta { shift ? frac + 1.f : frac };
+        const float a { (1.f - delta) / (1.f + delta) };
+        const float newer { shift ? x[2 * stride] : x[stride] };
+        const float older { shift ? x[stride] : x[0] };
+
+        state = a * (newer - state) + older;
+        return state;
+    }
+};
+
+// Windowed sinc interpolation over the samples at delays D - 7 to D + 8
+// Blackman windowed, with the kernels tabulated for Phases fractional delays and
+// linearly interpolated in between. Close to ideal up to about 0.4 of the sample rate
+struct WindowedSinc
+{
+    static constexpr unsigned int NumTaps { 16 };
+    static constexpr unsigned int NumNewerTaps { NumTaps / 2 - 1 };
+    static constexpr bool IsRecursive { false };
+    static constexpr unsigned int Phases { 256 };
+
+    // Kernel of every phase, oldest tap first, plus a last row for frac = 1
+    // Computed once at static initialisation
+    static const float (&table)[Phases + 1][NumTaps];
+
+    static inline float interpolate(const float* x, unsigned int stride, float frac, float& /*state*/) noexcept
+    {
+        const float p { frac * static_cast<float>(Phases) };
+        const unsigned int phase { static_cast<unsigned int>(p) };
+        const float pFrac { p - static_cast<float>(phase) };
+        const float* h0 { table[phase] };
+        const float* h1 { table[phase + 1] };
+
+        float y { 0.f };
+        for (unsigned int k = 0; k < NumTaps; ++k)
+            y += (h0[k] + pFrac * (h1[k] - h0[k])) * x[k * stride];
+
+        return y;
+    }
+};
+
+}
+
+}
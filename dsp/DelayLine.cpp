@@ -6,10 +6,12 @@
 namespace mrta
 {
 
-DelayLine::DelayLine(unsigned int maxLengthSamples, unsigned int numChannels)
+DelayLine::DelayLine(unsigned int newMaxLengthSamples, unsigned int numChannels, WrapMode newWrapMode, Layout newLayout) :
+    maxLengthSamples { newMaxLengthSamples },
+    wrapMode { newWrapMode },
+    layout { newLayout }
 {
-    for (unsigned int ch = 0; ch < numChannels; ++ch)
-        delayBuffer.emplace_back(maxLengthSamples, 0.f);
+    allocate(numChannels);
 }
 
 DelayLine::~DelayLine()
@@ -18,149 +20,836 @@ DelayLine::~DelayLine()
 
 void DelayLine::clear()
 {
-    for (auto& b : delayBuffer)
-        std::fill(b.begin(), b.end(), 0.f);
+    std::fill(delayBuffer.get(), delayBuffer.get() + allocatedSize, 0.f);
+    std::fill(interpolationState.begin(), interpolationState.end(), 0.f);
 }
 
-void DelayLine::prepare(unsigned int maxLengthSamples, unsigned int numChannels)
+void DelayLine::prepare(unsigned int newMaxLengthSamples, unsigned int numChannels)
 {
-    delayBuffer.clear();
-    for (unsigned int ch = 0; ch < numChannels; ++ch)
-        delayBuffer.emplace_back(maxLengthSamples, 0.f);
+    maxLengthSamples = newMaxLengthSamples;
+    allocate(numChannels);
+}
+
+void DelayLine::setWrapMode(WrapMode newWrapMode)
+{
+    wrapMode = newWrapMode;
+    allocate(numAllocatedChannels);
+}
+
+void DelayLine::setLayout(Layout newLayout)
+{
+    layout = newLayout;
+    allocate(numAllocatedChannels);
+}
+
+void DelayLine::allocate(unsigned int numChannels)
+{
+    // At least as long as the guard zone, so every sample of the guard zone has a mirror
+    bufferSize = std::max(maxLengthSamples + HistorySamples, GuardSamples);
+    if (wrapMode == PowerOfTwo)
+    {
+        unsigned int powerOfTwoSize { 1 };
+        while (powerOfTwoSize < bufferSize)
+            powerOfTwoSize <<= 1;
+
+        bufferSize = powerOfTwoSize;
+    }
+
+    const unsigned int alignedSamples { static_cast<unsigned int>(Alignment / sizeof(float)) };
+    if (layout == Interleaved)
+    {
+        channelStride = 1;
+        sampleStride = numChannels;
+    }
+    else
+    {
+        channelStride = ((bufferSize + GuardSamples + alignedSamples - 1) / alignedSamples) * alignedSamples;
+        sampleStride = 1;
+    }
+
+    // Keep the current storage if it is large enough
+    const std::size_t requiredSize { static_cast<std::size_t>(layout == Interleaved ? bufferSize + GuardSamples : channelStride) * numChannels };
+    if (requiredSize > allocatedSize)
+    {
+        delayBuffer.reset(static_cast<float*>(::operator new[](requiredSize * sizeof(float), std::align_val_t { Alignment })));
+        allocatedSize = requiredSize;
+    }
+
+    numAllocatedChannels = numChannels;
+    interpolationState.resize(2 * numChannels);
+    writeIndex = 0;
+    clear();
 }
 
+template<typename Interpolation>
 void DelayLine::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
 {
-    const unsigned int delayBufferSize { static_cast<unsigned int>(delayBuffer[0].size()) };
+    const bool integerDelay { transitionRemaining == 0 && delayFrac == 0.f };
+    if (wrapMode == PowerOfTwo)
+    {
+        if (integerDelay)
+            processFixed<PowerOfTwo>(output, input, numChannels, numSamples);
+        else
+            processFractional<PowerOfTwo, Interpolation>(output, input, numChannels, numSamples);
+    }
+    else
+    {
+        if (integerDelay)
+            processFixed<Modulo>(output, input, numChannels, numSamples);
+        else
+            processFractional<Modulo, Interpolation>(output, input, numChannels, numSamples);
+    }
+}
+
+template<typename Interpolation>
+void DelayLine::process(float* output, const float* input, unsigned int numChannels)
+{
+    const bool integerDelay { transitionRemaining == 0 && delayFrac == 0.f };
+    if (wrapMode == PowerOfTwo)
+    {
+        if (integerDelay)
+            processFixed<PowerOfTwo>(output, input, numChannels);
+        else
+            processFractional<PowerOfTwo, Interpolation>(output, input, numChannels);
+    }
+    else
+    {
+        if (integerDelay)
+            processFixed<Modulo>(output, input, numChannels);
+        else
+            processFractional<Modulo, Interpolation>(output, input, numChannels);
+    }
+}
+
+template<typename Interpolation>
+void DelayLine::process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    if (wrapMode == PowerOfTwo)
+        processModulated<PowerOfTwo, Interpolation>(audioOutput, audioInput, modInput, numChannels, numSamples);
+    else
+        processModulated<Modulo, Interpolation>(audioOutput, audioInput, modInput, numChannels, numSamples);
+}
+
+template<typename Interpolation>
+void DelayLine::process(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels)
+{
+    if (wrapMode == PowerOfTwo)
+        processModulated<PowerOfTwo, Interpolation>(audioOutput, audioInput, modInput, numChannels);
+    else
+        processModulated<Modulo, Interpolation>(audioOutput, audioInput, modInput, numChannels);
+}
+
+template<typename Interpolation>
+void DelayLine::processTaps(float* const* output, const float* const* input, const Tap* taps, unsigned int numTaps, unsigned int numChannels, unsigned int numSamples)
+{
+    if (wrapMode == PowerOfTwo)
+        processMultiTap<PowerOfTwo, Interpolation, true>(output, input, taps, numTaps, numChannels, numSamples);
+    else
+        processMultiTap<Modulo, Interpolation, true>(output, input, taps, numTaps, numChannels, numSamples);
+}
+
+template<typename Interpolation>
+void DelayLine::processTapOutputs(float* const* tapOutput, const float* const* input, const Tap* taps, unsigned int numTaps, unsigned int numChannels, unsigned int numSamples)
+{
+    if (wrapMode == PowerOfTwo)
+        processMultiTap<PowerOfTwo, Interpolation, false>(tapOutput, input, taps, numTaps, numChannels, numSamples);
+    else
+        processMultiTap<Modulo, Interpolation, false>(tapOutput, input, taps, numTaps, numChannels, numSamples);
+}
+
+template<DelayLine::WrapMode Mode>
+void DelayLine::processFixed(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    const unsigned int delayBufferSize { bufferSize };
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+    numChannels = std::min(numChannels, numAllocatedChannels);
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
         unsigned int workingWriteIndex { writeIndex };
-        unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
+        unsigned int workingReadIndex { wrap<Mode>(workingWriteIndex + delayBufferSize - delayInt, delayBufferSize) };
 
-        for (unsigned int n = 0; n < numSamples; ++n)
+        // Spans end where either index wraps, and are at most delayInt long,
+        // so the samples written by a span are never read by the same span
+        for (unsigned int n = 0; n < numSamples;)
         {
-            const float x { input[ch][n] };
-            output[ch][n] = delayBuffer[ch][workingReadIndex];
-            delayBuffer[ch][workingWriteIndex] = x;
-
-            ++workingWriteIndex; workingWriteIndex %= delayBufferSize;
-            ++workingReadIndex; workingReadIndex %= delayBufferSize;
+            const unsigned int span { std::min({ numSamples - n, delayBufferSize - workingReadIndex, delayBufferSize - workingWriteIndex, delayInt }) };
+            const float* x { input[ch] + n };
+            float* y { output[ch] + n };
+
+            // With the read position right ahead of the write position the span reads samples
+            // it also overwrites, so these go sample by sample like the other layouts
+            const bool overlap { workingReadIndex >= workingWriteIndex && workingReadIndex - workingWriteIndex < span };
+            if (layout == Planar && !overlap)
+            {
+                // Input is written first, in case output and input are the same buffer
+                float* buffer { &sample(ch, 0) };
+                std::copy(x, x + span, buffer + workingWriteIndex);
+                if (workingWriteIndex < GuardSamples)
+                    std::copy(x, x + std::min(span, GuardSamples - workingWriteIndex), buffer + delayBufferSize + workingWriteIndex);
+
+                std::copy(buffer + workingReadIndex, buffer + workingReadIndex + span, y);
+            }
+            else
+            {
+                for (unsigned int k = 0; k < span; ++k)
+                {
+                    const float xk { x[k] };
+                    y[k] = sample(ch, workingReadIndex + k);
+                    writeSample(ch, workingWriteIndex + k, xk);
+                }
+            }
+
+            n += span;
+            workingWriteIndex = wrap<Mode>(workingWriteIndex + span, delayBufferSize);
+            workingReadIndex = wrap<Mode>(workingReadIndex + span, delayBufferSize);
         }
     }
 
-    writeIndex += numSamples; writeIndex %= delayBufferSize;
+    writeIndex = wrap<Mode>(writeIndex + numSamples, delayBufferSize);
 }
 
-void DelayLine::process(float* output, const float* input, unsigned int numChannels)
+template<DelayLine::WrapMode Mode>
+void DelayLine::processFixed(float* output, const float* input, unsigned int numChannels)
 {
-    const unsigned int delayBufferSize{ static_cast<unsigned int>(delayBuffer[0].size()) };
+    const unsigned int delayBufferSize { bufferSize };
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+    numChannels = std::min(numChannels, numAllocatedChannels);
 
     unsigned int workingWriteIndex { writeIndex };
-    unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
+    unsigned int workingReadIndex { wrap<Mode>(workingWriteIndex + delayBufferSize - delayInt, delayBufferSize) };
 
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
         const float x { input[ch] };
-        output[ch] = delayBuffer[ch][workingReadIndex];
-        delayBuffer[ch][workingWriteIndex] = x;
+        output[ch] = sample(ch, workingReadIndex);
+        writeSample(ch, workingWriteIndex, x);
     }
 
-    ++writeIndex; writeIndex %= delayBufferSize;
+    writeIndex = wrap<Mode>(writeIndex + 1u, delayBufferSize);
 }
 
-void DelayLine::process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+template<DelayLine::WrapMode Mode, typename Interpolation>
+void DelayLine::processFractional(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
 {
-    const unsigned int delayBufferSize{ static_cast<unsigned int>(delayBuffer[0].size()) };
+    const unsigned int delayBufferSize { bufferSize };
+
+    // All channels follow the same delay change, which is stored after the last channel
+    float current { currentDelay };
+    unsigned int remaining { transitionRemaining };
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+    numChannels = std::min(numChannels, numAllocatedChannels);
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
-        // Calculate base indices based on fixed delay time
         unsigned int workingWriteIndex { writeIndex };
-        unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
+        current = currentDelay;
+        remaining = transitionRemaining;
 
         for (unsigned int n = 0; n < numSamples; ++n)
         {
-            // Linear interpolation coefficients
-            const float m { std::fmax(modInput[ch][n], 0.f) };
-            const float mFloor { std::floor(m) };
-            const float mFrac0 { m - mFloor };
-            const float mFrac1 { 1.f - mFrac0 };
+            if (remaining > 0)
+            {
+                --remaining;
+                if (delayUpdate == Smooth)
+                    current += delayStep;
+            }
+
+            // Same write order as the modulated processing
+            const float x { input[ch][n] };
+            if constexpr (Interpolation::NumNewerTaps > 0)
+                writeSample(ch, workingWriteIndex, x);
+
+            output[ch][n] = readFractional<Mode, Interpolation>(ch, workingWriteIndex, current, remaining);
+
+            if constexpr (Interpolation::NumNewerTaps == 0)
+                writeSample(ch, workingWriteIndex, x);
+
+            workingWriteIndex = wrap<Mode>(workingWriteIndex + 1u, delayBufferSize);
+        }
+    }
+
+    if (numChannels > 0)
+    {
+        transitionRemaining = remaining;
+        currentDelay = remaining > 0 ? current : delaySamples;
+    }
+
+    writeIndex = wrap<Mode>(writeIndex + numSamples, delayBufferSize);
+}
 
-            // Calculate read indices
-            const unsigned int readIndex0 { (workingReadIndex + delayBufferSize - static_cast<unsigned int>(mFloor)) % delayBufferSize };
-            const unsigned int readIndex1 { (readIndex0 + delayBufferSize - 1u) % delayBufferSize };
+template<DelayLine::WrapMode Mode, typename Interpolation>
+void DelayLine::processFractional(float* output, const float* input, unsigned int numChannels)
+{
+    const unsigned int delayBufferSize { bufferSize };
+
+    float current { currentDelay };
+    if (transitionRemaining > 0)
+    {
+        --transitionRemaining;
+        if (delayUpdate == Smooth)
+            current += delayStep;
+    }
+
+    numChannels = std::min(numChannels, numAllocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        const float x { input[ch] };
+        if constexpr (Interpolation::NumNewerTaps > 0)
+            writeSample(ch, writeIndex, x);
+
+        output[ch] = readFractional<Mode, Interpolation>(ch, writeIndex, current, transitionRemaining);
 
-            // Read from delay line
-            const float read0 = delayBuffer[ch][readIndex0];
-            const float read1 = delayBuffer[ch][readIndex1];
+        if constexpr (Interpolation::NumNewerTaps == 0)
+            writeSample(ch, writeIndex, x);
+    }
 
-            // Read audio input
-            const float x { audioInput[ch][n] };
+    currentDelay = transitionRemaining > 0 ? current : delaySamples;
+    writeIndex = wrap<Mode>(writeIndex + 1u, delayBufferSize);
+}
 
-            // Interpolate output
-            audioOutput[ch][n] = read0 * mFrac1 + read1 * mFrac0;
+template<DelayLine::WrapMode Mode, typename Interpolation>
+void DelayLine::processModulated(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    const unsigned int delayBufferSize { bufferSize };
+    const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
 
-            // Write input
-            delayBuffer[ch][workingWriteIndex] = x;
+    // Integer delays a whole chunk can be read with before writing its input:
+    // the newest taps are older than the chunk and the oldest taps are not overwritten by it
+    const unsigned int minChunkDelay { Interpolation::NumNewerTaps + ModulatedChunkSize };
+    const unsigned int maxChunkDelay { delayBufferSize > olderTaps + ModulatedChunkSize ? delayBufferSize - olderTaps - ModulatedChunkSize : 0 };
 
-            // Increament indices
-            ++workingWriteIndex; workingWriteIndex %= delayBufferSize;
-            ++workingReadIndex; workingReadIndex %= delayBufferSize;
+    float y[ModulatedChunkSize];
+    float frac[ModulatedChunkSize];
+    unsigned int delay[ModulatedChunkSize];
+    unsigned int oldestTap[ModulatedChunkSize];
+    float taps[Interpolation::NumTaps][ModulatedChunkSize];
+
+    numChannels = std::min(numChannels, numAllocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        unsigned int workingWriteIndex { writeIndex };
+        float state { interpolationState[ch] };
+
+        for (unsigned int n0 = 0; n0 < numSamples; n0 += ModulatedChunkSize)
+        {
+            const unsigned int chunkSize { std::min(numSamples - n0, ModulatedChunkSize) };
+            const float* mod { modInput[ch] + n0 };
+            const float* x { audioInput[ch] + n0 };
+
+            // Recursive policies and partial chunks go sample by sample
+            bool blocked { !Interpolation::IsRecursive && chunkSize == ModulatedChunkSize };
+            if (blocked)
+            {
+                // Split the modulation in integer and fractional delay, for all samples of the chunk
+                // m is never negative, so truncation is the floor, and negative and NaN modulation
+                // give 0 as with std::fmax, which is a library call that stops vectorisation
+                // The modulation only lengthens the delay, so the shortest one is delayInt
+                int maxFloor { 0 };
+                for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                {
+                    const float m { delayFrac + (mod[l] > 0.f ? mod[l] : 0.f) };
+                    const int mFloor { static_cast<int>(m) };
+                    frac[l] = m - static_cast<float>(mFloor);
+                    delay[l] = delayInt + static_cast<unsigned int>(mFloor);
+                    maxFloor = std::max(maxFloor, mFloor);
+                }
+
+                blocked = delayInt >= minChunkDelay && delayInt + static_cast<unsigned int>(maxFloor) <= maxChunkDelay;
+            }
+
+            if (blocked)
+            {
+                // Oldest tap of every sample, the bounded delays need a single conditional wrap
+                for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                {
+                    const unsigned int index { workingWriteIndex + l + delayBufferSize - delay[l] - olderTaps };
+                    oldestTap[l] = index >= delayBufferSize ? index - delayBufferSize : index;
+                }
+
+                float unusedState { 0.f };
+                if constexpr (Interpolation::NumTaps <= 4)
+                {
+                    // Gather the few taps of every sample and interpolate all samples of the chunk at once,
+                    // tap k of sample l is at taps[k][l]
+                    const float* channel { &sample(ch, 0) };
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        for (unsigned int k = 0; k < Interpolation::NumTaps; ++k)
+                            taps[k][l] = channel[(oldestTap[l] + k) * sampleStride];
+
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        y[l] = Interpolation::interpolate(&taps[0][l], ModulatedChunkSize, frac[l], unusedState);
+                }
+                else
+                {
+                    // Long kernels vectorise over their own taps, read in place
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        y[l] = Interpolation::interpolate(&sample(ch, oldestTap[l]), sampleStride, frac[l], unusedState);
+                }
+
+                // Write input, before the output in case they are the same buffer
+                if (workingWriteIndex >= GuardSamples && workingWriteIndex + ModulatedChunkSize <= delayBufferSize)
+                {
+                    float* channel { &sample(ch, workingWriteIndex) };
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        channel[l * sampleStride] = x[l];
+
+                    workingWriteIndex = wrap<Mode>(workingWriteIndex + ModulatedChunkSize, delayBufferSize);
+                }
+                else
+                {
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                    {
+                        writeSample(ch, workingWriteIndex, x[l]);
+                        workingWriteIndex = wrap<Mode>(workingWriteIndex + 1u, delayBufferSize);
+                    }
+                }
+
+                std::copy(y, y + ModulatedChunkSize, audioOutput[ch] + n0);
+                continue;
+            }
+
+            for (unsigned int n = 0; n < chunkSize; ++n)
+            {
+                // Split the modulation in integer and fractional delay
+                const float m { delayFrac + std::fmax(mod[n], 0.f) };
+                const float mFloor { std::floor(m) };
+                const float mFrac { m - mFloor };
+
+                // Integer delay, long enough for the newer taps to be already written
+                const unsigned int sampleDelay { std::max(delayInt + static_cast<unsigned int>(mFloor), Interpolation::NumNewerTaps) };
+
+                // Index of the oldest tap, the newer ones can be in the guard zone
+                const unsigned int readIndex { wrap<Mode>(workingWriteIndex + delayBufferSize - sampleDelay - olderTaps, delayBufferSize) };
+
+                // Write input before reading only if the newest tap can be the current input,
+                // otherwise the oldest tap can still reach the sample at the write index
+                const float xn { x[n] };
+                if constexpr (Interpolation::NumNewerTaps > 0)
+                    writeSample(ch, workingWriteIndex, xn);
+
+                // Interpolate output
+                audioOutput[ch][n0 + n] = Interpolation::interpolate(&sample(ch, readIndex), sampleStride, mFrac, state);
+
+                if constexpr (Interpolation::NumNewerTaps == 0)
+                    writeSample(ch, workingWriteIndex, xn);
+
+                // Increament index
+                workingWriteIndex = wrap<Mode>(workingWriteIndex + 1u, delayBufferSize);
+            }
         }
+
+        interpolationState[ch] = state;
     }
 
     // Update persistent write index
-    writeIndex += numSamples; writeIndex %= delayBufferSize;
+    writeIndex = wrap<Mode>(writeIndex + numSamples, delayBufferSize);
 }
 
-void DelayLine::process(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels)
+template<DelayLine::WrapMode Mode, typename Interpolation>
+void DelayLine::processModulated(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels)
 {
-    const unsigned int delayBufferSize{ static_cast<unsigned int>(delayBuffer[0].size()) };
+    const unsigned int delayBufferSize { bufferSize };
+    const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
 
-    // Calculate base indices based on fixed delay time
-    unsigned int workingWriteIndex { writeIndex };
-    unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
-
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+    numChannels = std::min(numChannels, numAllocatedChannels);
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
-        // Linear interpolation coefficients
-        const float m { std::fmax(modInput[ch], 0.f) };
+        // Split the modulation in integer and fractional delay
+        const float m { delayFrac + std::fmax(modInput[ch], 0.f) };
         const float mFloor { std::floor(m) };
-        const float mFrac0 { m - mFloor };
-        const float mFrac1 { 1.f - mFrac0 };
+        const float mFrac { m - mFloor };
 
-        // Calculate read indeces
-        const unsigned int readIndex0 { (workingReadIndex + delayBufferSize - static_cast<unsigned int>(mFloor)) % delayBufferSize };
-        const unsigned int readIndex1 { (readIndex0 + delayBufferSize - 1u) % delayBufferSize };
+        // Integer delay, long enough for the newer taps to be already written
+        const unsigned int delay { std::max(delayInt + static_cast<unsigned int>(mFloor), Interpolation::NumNewerTaps) };
 
-        // Read from delay line
-        const float read0 = delayBuffer[ch][readIndex0];
-        const float read1 = delayBuffer[ch][readIndex1];
+        // Index of the oldest tap, the newer ones can be in the guard zone
+        const unsigned int readIndex { wrap<Mode>(writeIndex + delayBufferSize - delay - olderTaps, delayBufferSize) };
 
-        // Read audio input
+        // Same write order as the multi sample flavour
         const float x { audioInput[ch] };
+        if constexpr (Interpolation::NumNewerTaps > 0)
+            writeSample(ch, writeIndex, x);
 
         // Interpolate output
-        audioOutput[ch] = read0 * mFrac1 + read1 * mFrac0;
+        audioOutput[ch] = Interpolation::interpolate(&sample(ch, readIndex), sampleStride, mFrac, interpolationState[ch]);
 
-        // Write input
-        delayBuffer[ch][workingWriteIndex] = x;
+        if constexpr (Interpolation::NumNewerTaps == 0)
+            writeSample(ch, writeIndex, x);
     }
 
     // Update persistent write index
-    ++writeIndex; writeIndex %= delayBufferSize;
+    writeIndex = wrap<Mode>(writeIndex + 1u, delayBufferSize);
 }
 
-void DelayLine::setDelaySamples(unsigned int newDelaySamples)
+template<DelayLine::WrapMode Mode, typename Interpolation, bool SumTaps>
+void DelayLine::processMultiTap(float* const* output, const float* const* input, const Tap* taps, unsigned int numTaps, unsigned int numChannels, unsigned int numSamples)
 {
-    delaySamples = std::max(std::min(newDelaySamples, static_cast<unsigned int>(delayBuffer[0].size() - 1u)), 1u);
+    static_assert(!Interpolation::IsRecursive, "Multi tap reads need a non recursive interpolation");
+
+    const unsigned int delayBufferSize { bufferSize };
+    const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+
+    // The newest sample read by a tap must be older than the current sample,
+    // and the oldest one must still be in the buffer
+    const unsigned int minDelay { Interpolation::NumNewerTaps + 1 };
+    const unsigned int maxDelay { std::max(std::min(maxLengthSamples - 1u, delayBufferSize - olderTaps), minDelay) };
+
+    // Chunks are never longer than the shortest tap delay, minus the newer samples the interpolation reads
+    unsigned int maxChunkSize { TapChunkSize };
+    for (unsigned int t = 0; t < numTaps; ++t)
+    {
+        const float delay { std::fmin(std::fmax(taps[t].delaySamples, static_cast<float>(minDelay)), static_cast<float>(maxDelay)) };
+        maxChunkSize = std::min(maxChunkSize, static_cast<unsigned int>(delay) - Interpolation::NumNewerTaps);
+    }
+
+    float x[TapChunkSize];
+    float acc[TapChunkSize];
+
+    numChannels = std::min(numChannels, numAllocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        unsigned int workingWriteIndex { writeIndex };
+
+        for (unsigned int n0 = 0; n0 < numSamples; n0 += maxChunkSize)
+        {
+            const unsigned int chunkSize { std::min(numSamples - n0, maxChunkSize) };
+
+            // Keep the input of the chunk, the outputs can be the same buffer
+            std::copy(input[ch] + n0, input[ch] + n0 + chunkSize, x);
+
+            if constexpr (SumTaps)
+                std::fill(acc, acc + chunkSize, 0.f);
+
+            for (unsigned int t = 0; t < numTaps; ++t)
+            {
+                const Tap& tap { taps[t] };
+                float* y { acc };
+                if constexpr (!SumTaps)
+                {
+                    y = output[ch * numTaps + t] + n0;
+                    std::fill(y, y + chunkSize, 0.f);
+                }
+
+                const float delay { std::fmin(std::fmax(tap.delaySamples, static_cast<float>(minDelay)), static_cast<float>(maxDelay)) };
+                const unsigned int tapDelayInt { static_cast<unsigned int>(delay) };
+                const float tapDelayFrac { delay - static_cast<float>(tapDelayInt) };
+
+                if (tap.modulation == nullptr)
+                {
+                    // Runs end where the oldest sample of the tap wraps, the newer ones can be in the guard zone
+                    unsigned int readIndex { wrap<Mode>(workingWriteIndex + delayBufferSize - tapDelayInt - olderTaps, delayBufferSize) };
+                    for (unsigned int n = 0; n < chunkSize;)
+                    {
+                        const unsigned int run { std::min(chunkSize - n, delayBufferSize - readIndex) };
+                        if (layout == Planar)
+                            accumulateTap<Interpolation>(y + n, &sample(ch, readIndex), 1u, run, tapDelayFrac, tap.gain);
+                        else
+                            accumulateTap<Interpolation>(y + n, &sample(ch, readIndex), sampleStride, run, tapDelayFrac, tap.gain);
+
+                        n += run;
+                        readIndex = wrap<Mode>(readIndex + run, delayBufferSize);
+                    }
+                }
+                else
+                {
+                    float state { 0.f };
+                    for (unsigned int n = 0; n < chunkSize; ++n)
+                    {
+                        // Split the modulated delay in integer and fractional delay
+                        const float m { tapDelayFrac + std::fmax(tap.modulation[n0 + n], 0.f) };
+                        const float mFloor { std::floor(m) };
+                        const unsigned int modDelay { std::min(tapDelayInt + static_cast<unsigned int>(mFloor), maxDelay) };
+                        const float modFrac { modDelay < maxDelay ? m - mFloor : 0.f };
+
+                        const unsigned int readIndex { wrap<Mode>(workingWriteIndex + n + delayBufferSize - modDelay - olderTaps, delayBufferSize) };
+                        y[n] += tap.gain * Interpolation::interpolate(&sample(ch, readIndex), sampleStride, modFrac, state);
+                    }
+                }
+            }
+
+            if constexpr (SumTaps)
+                std::copy(acc, acc + chunkSize, output[ch] + n0);
+
+            // Write the chunk once all taps read it
+            for (unsigned int n = 0; n < chunkSize; ++n)
+            {
+                writeSample(ch, workingWriteIndex, x[n]);
+                workingWriteIndex = wrap<Mode>(workingWriteIndex + 1u, delayBufferSize);
+            }
+        }
+    }
+
+    writeIndex = wrap<Mode>(writeIndex + numSamples, delayBufferSize);
+}
+
+DelayLine::Reader::Reader()
+{
+}
+
+DelayLine::Reader::Reader(unsigned int numChannels)
+{
+    prepare(numChannels);
+}
+
+void DelayLine::Reader::prepare(unsigned int numChannels)
+{
+    interpolationState.resize(numChannels);
+    clear();
+}
+
+void DelayLine::Reader::clear()
+{
+    std::fill(interpolationState.begin(), interpolationState.end(), 0.f);
+}
+
+void DelayLine::Reader::setDelaySamples(float newDelaySamples)
+{
+    delaySamples = std::fmax(newDelaySamples, 1.f);
+    delayInt = static_cast<unsigned int>(delaySamples);
+    delayFrac = delaySamples - static_cast<float>(delayInt);
+}
+
+void DelayLine::write(const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, numAllocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        unsigned int workingWriteIndex { writeIndex };
+        for (unsigned int n = 0; n < numSamples; ++n)
+        {
+            writeSample(ch, workingWriteIndex, input[ch][n]);
+            workingWriteIndex = workingWriteIndex + 1u < bufferSize ? workingWriteIndex + 1u : 0u;
+        }
+    }
+}
+
+template<typename Interpolation>
+void DelayLine::read(Reader& reader, float* const* output, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    if (wrapMode == PowerOfTwo)
+        readShared<PowerOfTwo, Interpolation>(reader, output, modInput, numChannels, numSamples);
+    else
+        readShared<Modulo, Interpolation>(reader, output, modInput, numChannels, numSamples);
+}
+
+void DelayLine::readInterleaved(float* output, const unsigned int* channelDelays, unsigned int numChannels, unsigned int numSamples)
+{
+    // The frame stride is the caller's channel count, even if fewer are allocated
+    const unsigned int frameSize { numChannels };
+    numChannels = std::min(numChannels, numAllocatedChannels);
+
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        // Delays out of range are clamped, so the block never reads past the write position or the buffer
+        const unsigned int delay { std::min(std::max(channelDelays[ch], numSamples), bufferSize) };
+        const unsigned int index { writeIndex + bufferSize - delay };
+        const unsigned int readIndex { index >= bufferSize ? index - bufferSize : index };
+
+        // Split in two runs where the read position wraps around
+        const unsigned int first { std::min(numSamples, bufferSize - readIndex) };
+        const float* x { &sample(ch, readIndex) };
+        for (unsigned int n = 0; n < first; ++n)
+            output[n * frameSize + ch] = x[n * sampleStride];
+
+        x = &sample(ch, 0);
+        for (unsigned int n = first; n < numSamples; ++n)
+            output[n * frameSize + ch] = x[(n - first) * sampleStride];
+    }
+}
+
+void DelayLine::writeInterleaved(const float* input, unsigned int numChannels, unsigned int numSamples)
+{
+    const unsigned int frameSize { numChannels };
+    numChannels = std::min(numChannels, numAllocatedChannels);
+
+    // Split in two runs where the write position wraps around
+    const unsigned int first { std::min(numSamples, bufferSize - writeIndex) };
+    const unsigned int runStart[2] { writeIndex, 0 };
+    const unsigned int runLength[2] { first, numSamples - first };
+
+    for (unsigned int r = 0; r < 2; ++r)
+    {
+        const float* x { input + r * first * frameSize };
+        if (layout == Interleaved && frameSize == numAllocatedChannels)
+        {
+            std::copy(x, x + runLength[r] * frameSize, &sample(0, runStart[r]));
+        }
+        else
+        {
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+            {
+                float* y { &sample(ch, runStart[r]) };
+                for (unsigned int n = 0; n < runLength[r]; ++n)
+                    y[n * sampleStride] = x[n * frameSize + ch];
+            }
+        }
+    }
+
+    // Mirror the start of the buffer in the guard zone, if the block wrote to it
+    if (writeIndex < GuardSamples || numSamples > first)
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int i = 0; i < GuardSamples; ++i)
+                sample(ch, i + bufferSize) = sample(ch, i);
+}
+
+template<DelayLine::WrapMode Mode, typename Interpolation>
+void DelayLine::readShared(Reader& reader, float* const* output, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    const unsigned int delayBufferSize { bufferSize };
+    const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+    const unsigned int maxDelay { getMaxSharedDelay<Interpolation>(numSamples) };
+
+    float frac[ModulatedChunkSize];
+    unsigned int oldestTap[ModulatedChunkSize];
+    float taps[Interpolation::NumTaps][ModulatedChunkSize];
+
+    numChannels = std::min({ numChannels, numAllocatedChannels, static_cast<unsigned int>(reader.interpolationState.size()) });
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        unsigned int workingWriteIndex { writeIndex };
+
+        for (unsigned int n0 = 0; n0 < numSamples; n0 += ModulatedChunkSize)
+        {
+            const unsigned int chunkSize { std::min(numSamples - n0, ModulatedChunkSize) };
+            const float* mod { modInput[ch] + n0 };
+            float* y { output[ch] + n0 };
+
+            // The whole block is already written, so a chunk is read at once when all its delays are
+            // in range, as in the modulated process. Recursive policies and partial chunks go sample by sample
+            bool blocked { !Interpolation::IsRecursive && chunkSize == ModulatedChunkSize };
+            if (blocked)
+            {
+                int maxFloor { 0 };
+                for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                {
+                    const float m { reader.delayFrac + (mod[l] > 0.f ? mod[l] : 0.f) };
+                    const int mFloor { static_cast<int>(m) };
+                    frac[l] = m - static_cast<float>(mFloor);
+                    oldestTap[l] = workingWriteIndex + l + delayBufferSize - reader.delayInt - static_cast<unsigned int>(mFloor) - olderTaps;
+                    maxFloor = std::max(maxFloor, mFloor);
+                }
+
+                blocked = reader.delayInt >= Interpolation::NumNewerTaps && reader.delayInt + static_cast<unsigned int>(maxFloor) < maxDelay;
+            }
+
+            if (blocked)
+            {
+                for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                    oldestTap[l] = oldestTap[l] >= delayBufferSize ? oldestTap[l] - delayBufferSize : oldestTap[l];
+
+                float unusedState { 0.f };
+                if constexpr (Interpolation::NumTaps <= 4)
+                {
+                    const float* channel { &sample(ch, 0) };
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        for (unsigned int k = 0; k < Interpolation::NumTaps; ++k)
+                            taps[k][l] = channel[(oldestTap[l] + k) * sampleStride];
+
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        y[l] = Interpolation::interpolate(&taps[0][l], ModulatedChunkSize, frac[l], unusedState);
+                }
+                else
+                {
+                    for (unsigned int l = 0; l < ModulatedChunkSize; ++l)
+                        y[l] = Interpolation::interpolate(&sample(ch, oldestTap[l]), sampleStride, frac[l], unusedState);
+                }
+
+                workingWriteIndex = wrap<Mode>(workingWriteIndex + ModulatedChunkSize, delayBufferSize);
+                continue;
+            }
+
+            for (unsigned int n = 0; n < chunkSize; ++n)
+            {
+                y[n] = readModulated<Interpolation>(reader, ch, workingWriteIndex, mod[n], maxDelay);
+                workingWriteIndex = wrap<Mode>(workingWriteIndex + 1u, delayBufferSize);
+            }
+        }
+    }
+}
+
+void DelayLine::setDelaySamples(float newDelaySamples)
+{
+    newDelaySamples = std::fmax(std::fmin(newDelaySamples, static_cast<float>(maxLengthSamples) - 1.f), 1.f);
+    if (newDelaySamples == delaySamples)
+        return;
+
+    if (delayUpdate == Jump || transitionSamples == 0)
+    {
+        currentDelay = newDelaySamples;
+        transitionRemaining = 0;
+    }
+    else if (delayUpdate == Smooth)
+    {
+        // Start from where the delay is now, the change keeps its full duration
+        delayStep = (newDelaySamples - currentDelay) / static_cast<float>(transitionSamples);
+        transitionRemaining = transitionSamples;
+    }
+    else
+    {
+        // The previous read position is the current target, unless a crossfade in progress
+        // is still closer to its own previous read position
+        if (transitionRemaining == 0 || 2 * transitionRemaining < transitionSamples)
+        {
+            currentDelay = delaySamples;
+            std::swap_ranges(interpolationState.begin(), interpolationState.begin() + numAllocatedChannels, interpolationState.begin() + numAllocatedChannels);
+        }
+
+        delayStep = 1.f / static_cast<float>(transitionSamples);
+        transitionRemaining = transitionSamples;
+    }
+
+    delaySamples = newDelaySamples;
+    delayInt = static_cast<unsigned int>(delaySamples);
+    delayFrac = delaySamples - static_cast<float>(delayInt);
+}
+
+void DelayLine::setDelayUpdate(DelayUpdate newDelayUpdate, unsigned int newTransitionSamples)
+{
+    delayUpdate = newDelayUpdate;
+    transitionSamples = newTransitionSamples;
+
+    // A change in progress finishes right away
+    transitionRemaining = 0;
+    currentDelay = delaySamples;
 }
 
+template void DelayLine::process<DelayInterpolation::Linear>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::Lagrange3>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::Hermite3>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::Thiran1>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, const float* const*, unsigned int, unsigned int);
+
+template void DelayLine::process<DelayInterpolation::Linear>(float*, const float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::Lagrange3>(float*, const float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::Hermite3>(float*, const float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::Thiran1>(float*, const float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::WindowedSinc>(float*, const float*, const float*, unsigned int);
+
+template void DelayLine::processTaps<DelayInterpolation::Linear>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+template void DelayLine::processTaps<DelayInterpolation::Lagrange3>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+template void DelayLine::processTaps<DelayInterpolation::Hermite3>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+template void DelayLine::processTaps<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+
+template void DelayLine::processTapOutputs<DelayInterpolation::Linear>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+template void DelayLine::processTapOutputs<DelayInterpolation::Lagrange3>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+template void DelayLine::processTapOutputs<DelayInterpolation::Hermite3>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+template void DelayLine::processTapOutputs<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, const Tap*, unsigned int, unsigned int, unsigned int);
+
+template void DelayLine::process<DelayInterpolation::Linear>(float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::Lagrange3>(float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::Hermite3>(float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::Thiran1>(float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::process<DelayInterpolation::WindowedSinc>(float* const*, const float* const*, unsigned int, unsigned int);
+
+template void DelayLine::process<DelayInterpolation::Linear>(float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::Lagrange3>(float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::Hermite3>(float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::Thiran1>(float*, const float*, unsigned int);
+template void DelayLine::process<DelayInterpolation::WindowedSinc>(float*, const float*, unsigned int);
+
+template void DelayLine::read<DelayInterpolation::Linear>(Reader&, float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::read<DelayInterpolation::Lagrange3>(Reader&, float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::read<DelayInterpolation::Hermite3>(Reader&, float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::read<DelayInterpolation::Thiran1>(Reader&, float* const*, const float* const*, unsigned int, unsigned int);
+template void DelayLine::read<DelayInterpolation::WindowedSinc>(Reader&, float* const*, const float* const*, unsigned int, unsigned int);
 
 }
@@ -1,5 +1,12 @@
 #pragma once
 
+#include "DelayInterpolation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <vector>
 
 namespace mrta
@@ -8,7 +15,40 @@ namespace mrta
 class DelayLine
 {
 public:
-    DelayLine(unsigned int maxLengthSamples, unsigned int numChannels);
+    enum WrapMode : unsigned int
+    {
+        // Buffer holds maxLengthSamples and the history of the interpolation, indices wrap with an integer modulo
+        Modulo = 0,
+
+        // Buffer capacity is rounded up to a power of two, indices wrap with a bitmask
+        // Uses up to twice the memory, the maximum delay is still maxLengthSamples
+        PowerOfTwo
+    };
+
+    enum Layout : unsigned int
+    {
+        // One block of samples per channel, best for the multi sample process methods
+        Planar = 0,
+
+        // The channels of a sample are next to each other, best for the single sample
+        // process methods, which then touch one cache line for all channels
+        Interleaved
+    };
+
+    enum DelayUpdate : unsigned int
+    {
+        // The read position jumps to the new delay time
+        Jump = 0,
+
+        // The delay time moves linearly to the new value over the transition,
+        // reading with the interpolation, which bends the pitch meanwhile
+        Smooth,
+
+        // The output crossfades from the old to the new read position over the transition
+        Crossfade
+    };
+
+    DelayLine(unsigned int maxLengthSamples, unsigned int numChannels, WrapMode wrapMode = Modulo, Layout layout = Planar);
     ~DelayLine();
 
     // No default ctor
@@ -25,31 +65,370 @@ public:
     // Clear the contents of the delay buffer
     void clear();
 
-    // Reallocate delay buffer for the new channel count and clear its contents
+    // Resize delay buffer for the new length and channel count and clear its contents
+    // The storage is only reallocated if it needs to grow
     void prepare(unsigned int maxLengthSamples, unsigned int numChannels);
 
+    // Set how the buffer indices wrap around
+    // Calling this method will resize the delay buffer and clear its contents
+    void setWrapMode(WrapMode newWrapMode);
+
+    // Set how the channels are laid out in the delay buffer
+    // Calling this method will clear the delay buffer
+    void setLayout(Layout newLayout);
+
     // Process audio with the currently (fixed) set delay time
+    // Integer delays run as block copies, split only where the read or write position wraps around
+    // Fractional delays and delay changes in progress read with the Interpolation policy
+    template<typename Interpolation = DelayInterpolation::Linear>
     void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
 
     // Single sample flavour of the fixed delay time processing
+    template<typename Interpolation = DelayInterpolation::Linear>
     void process(float* output, const float* input, unsigned int numChannels);
 
     // Process audio thru the delay line with audio rate modulation
     // The modulation input is a audio rate signal with the time modulation in samples
-    // on top of the currently set delay time
-    // The modulation input supports fractional values and uses linear interpolation
+    // on top of the currently set delay time, delay changes apply right away
+    // The modulation input supports fractional values, interpolated with one of the
+    // DelayInterpolation policies, linear by default
+    // Chunks of samples whose delays stay within the buffer are read together, with the
+    // read positions and the interpolation of all samples computed in vectorisable loops
+    // Policies with newer taps need that many samples of delay, shorter delays are clamped
+    template<typename Interpolation = DelayInterpolation::Linear>
     void process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
                  unsigned int numChannels, unsigned int numSamples);
 
     // Single sample flavour of the modulated delay time processing
+    template<typename Interpolation = DelayInterpolation::Linear>
     void process(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels);
 
-    // Set the current delay time in samples
-    void setDelaySamples(unsigned int samples);
+    // Multi tap read, the taps read the delay line independently of the set delay time
+    struct Tap
+    {
+        // Delay in samples, fractional delays are interpolated
+        // Limited to maxLengthSamples - 1 and to at least the newer taps of the interpolation plus one
+        float delaySamples { 1.f };
+
+        // Gain of the tap
+        float gain { 1.f };
+
+        // Optional audio rate modulation in samples on top of delaySamples, nullptr for none
+        // Shared by all channels, negative values are ignored
+        const float* modulation { nullptr };
+    };
+
+    // Write the input once and read numTaps taps per channel, summed with their gains into output
+    // Reads run in chunks no longer than the shortest tap delay, so a chunk only reads samples
+    // written before it, and taps without modulation read each chunk as one contiguous run
+    // The interpolation must not be recursive, as the taps do not keep a state
+    template<typename Interpolation = DelayInterpolation::Linear>
+    void processTaps(float* const* output, const float* const* input, const Tap* taps, unsigned int numTaps,
+                     unsigned int numChannels, unsigned int numSamples);
+
+    // Same as processTaps, but every tap goes to its own output with its gain,
+    // tap t of channel ch is written to tapOutput[ch * numTaps + t]
+    template<typename Interpolation = DelayInterpolation::Linear>
+    void processTapOutputs(float* const* tapOutput, const float* const* input, const Tap* taps, unsigned int numTaps,
+                           unsigned int numChannels, unsigned int numSamples);
+
+    // Read position on a delay line shared by several readers, e.g. the voices of a chorus
+    // Every reader has its own delay time and interpolation state, and is only a few floats,
+    // so any number of voices read the same buffer, which is written only once
+    class Reader
+    {
+    public:
+        Reader();
+        explicit Reader(unsigned int numChannels);
+
+        // Resize the interpolation state for numChannels and clear it
+        void prepare(unsigned int numChannels);
+
+        // Clear the interpolation state
+        void clear();
+
+        // Set the delay time in samples, the modulation of DelayLine::read is added on top of it
+        // Limited to at least 1 sample, reads further limit it to the length of the delay line
+        void setDelaySamples(float samples);
+
+        // return the delay time in samples
+        float getDelaySamples() const noexcept { return delaySamples; }
+
+    private:
+        friend class DelayLine;
+
+        float delaySamples { 1.f };
+        unsigned int delayInt { 1 };
+        float delayFrac { 0.f };
+
+        // State of the recursive interpolation policies, one per channel
+        std::vector<float> interpolationState;
+    };
+
+    // Shared write and multi reader processing
+    // For every sample (or block): write the input once, read it with every reader,
+    // then advance the write position. The delay line's own delay time is not used
+    // E.g. per sample: write(x, numChannels); read(voice, y, mod, numChannels) for every voice; advance();
+    // The single sample methods are defined here, so per sample effects (e.g. with feedback) inline them
+
+    // Write the current input sample of channel ch, at the write position
+    // ch is not checked against the allocated channels
+    void write(unsigned int ch, float x) noexcept { writeSample(ch, writeIndex, x); }
+
+    // Write the current input sample of every channel, at the write position
+    void write(const float* input, unsigned int numChannels) noexcept
+    {
+        numChannels = std::min(numChannels, numAllocatedChannels);
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            write(ch, input[ch]);
+    }
+
+    // Write a block of input samples from the write position on
+    void write(const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Read the current sample of channel ch with reader, with modulation in samples on top of its delay time,
+    // same as the modulated process. The current sample is already written, so the delay only needs to
+    // reach the newer taps of the interpolation, and the delay is limited so the oldest tap stays in the buffer
+    // ch is not checked against the allocated channels or the channels of reader
+    template<typename Interpolation = DelayInterpolation::Linear>
+    float readInterpolated(Reader& reader, unsigned int ch, float mod) noexcept
+    {
+        return readModulated<Interpolation>(reader, ch, writeIndex, mod, getMaxSharedDelay<Interpolation>(1u));
+    }
+
+    // Read the current sample of every channel with reader, modulated by modInput
+    template<typename Interpolation = DelayInterpolation::Linear>
+    void read(Reader& reader, float* output, const float* modInput, unsigned int numChannels) noexcept
+    {
+        numChannels = std::min({ numChannels, numAllocatedChannels, static_cast<unsigned int>(reader.interpolationState.size()) });
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            output[ch] = readInterpolated<Interpolation>(reader, ch, modInput[ch]);
+    }
+
+    // Read the block written last with reader, every sample at its own write position
+    // The block overwrites the oldest numSamples samples of the buffer, so the longest delay is
+    // numSamples shorter, prepare the delay line with the block size added to the longest delay
+    template<typename Interpolation = DelayInterpolation::Linear>
+    void read(Reader& reader, float* const* output, const float* const* modInput, unsigned int numChannels, unsigned int numSamples);
+
+    // Move the write position numSamples forward, after the current sample or block was read
+    void advance(unsigned int numSamples = 1) noexcept
+    {
+        // Blocks are shorter than the buffer, so a single conditional wrap is enough
+        const unsigned int index { writeIndex + (numSamples < bufferSize ? numSamples : numSamples % bufferSize) };
+        writeIndex = index >= bufferSize ? index - bufferSize : index;
+    }
+
+    // Read numSamples samples of every channel at its own integer delay, from the write position on,
+    // for networks of delays stored as the channels of one delay line, e.g. a feedback delay network
+    // Frame interleaved output, sample n of channel ch is at output[n * numChannels + ch]
+    // The block is read before it is written, so the delays must be in [numSamples, maxLengthSamples],
+    // then write the block with writeInterleaved and advance
+    void readInterleaved(float* output, const unsigned int* channelDelays, unsigned int numChannels, unsigned int numSamples);
+
+    // Write a block of frame interleaved input from the write position on, without advancing it
+    // With the Interleaved layout and all channels, the block is copied to the buffer as is
+    void writeInterleaved(const float* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Set the current delay time in samples, limited to [1, maxLengthSamples - 1]
+    // Fractional delays are interpolated, changes follow the DelayUpdate strategy
+    // Setting the same delay again does not restart a change in progress
+    void setDelaySamples(float samples);
+
+    // Set how changes of the fixed delay time are applied, and their duration in samples
+    // A transition of 0 samples jumps to the new delay time whatever the strategy
+    void setDelayUpdate(DelayUpdate newDelayUpdate, unsigned int newTransitionSamples);
+
+    // return the current target delay time in samples
+    float getDelaySamples() const noexcept { return delaySamples; }
+
+    // return the current wrap mode
+    WrapMode getWrapMode() const noexcept { return wrapMode; }
+
+    // return the current layout
+    Layout getLayout() const noexcept { return layout; }
 
 private:
-    std::vector<std::vector<float>> delayBuffer;
-    unsigned int delaySamples { 0 };
+    // Alignment of the delay buffer in bytes, a cache line
+    // In Planar layout every channel starts on an aligned address
+    static constexpr std::size_t Alignment { 64 };
+
+    struct AlignedDeleter
+    {
+        void operator()(float* p) const { ::operator delete[](p, std::align_val_t { Alignment }); }
+    };
+
+    // Every channel is followed by a guard zone mirroring its first GuardSamples samples,
+    // so interpolated reads of up to GuardSamples + 1 neighbour samples never wrap
+    static constexpr unsigned int GuardSamples { 16 };
+    static_assert(DelayInterpolation::WindowedSinc::NumTaps <= GuardSamples + 1, "Guard zone too short for the interpolation taps");
+
+    // Samples kept beyond maxLengthSamples, for the older taps of the interpolation and the sample
+    // written before the read, so every policy reads fractional delays up to maxLengthSamples - 1
+    static constexpr unsigned int HistorySamples { DelayInterpolation::WindowedSinc::NumTaps - DelayInterpolation::WindowedSinc::NumNewerTaps };
+
+    // Size the buffer of every channel for maxLengthSamples and the history, rounded up in PowerOfTwo mode,
+    // and update the strides for the current layout
+    void allocate(unsigned int numChannels);
+
+    // Sample at index of channel ch, index can reach into the guard zone
+    float& sample(unsigned int ch, unsigned int index) noexcept { return delayBuffer[ch * channelStride + index * sampleStride]; }
+
+    // Write a sample at index of channel ch, and to its mirror in the guard zone
+    void writeSample(unsigned int ch, unsigned int index, float x) noexcept
+    {
+        sample(ch, index) = x;
+        if (index < GuardSamples)
+            sample(ch, index + bufferSize) = x;
+    }
+
+    // Implementation of the process methods above for one wrap mode
+    template<WrapMode Mode>
+    void processFixed(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    template<WrapMode Mode>
+    void processFixed(float* output, const float* input, unsigned int numChannels);
+
+    // Fixed delay processing for fractional delays and delay changes in progress
+    template<WrapMode Mode, typename Interpolation>
+    void processFractional(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    template<WrapMode Mode, typename Interpolation>
+    void processFractional(float* output, const float* input, unsigned int numChannels);
+
+    // Output of channel ch for the current delay change, at write position index
+    // remaining is the number of samples of the change left after this one
+    template<WrapMode Mode, typename Interpolation>
+    inline float readFractional(unsigned int ch, unsigned int index, float current, unsigned int remaining) noexcept
+    {
+        if (remaining == 0)
+            return readDelayed<Mode, Interpolation>(ch, index, delaySamples, interpolationState[ch]);
+
+        if (delayUpdate == Smooth)
+            return readDelayed<Mode, Interpolation>(ch, index, current, interpolationState[ch]);
+
+        const float gain { 1.f - static_cast<float>(remaining) * delayStep };
+        const float previous { readDelayed<Mode, Interpolation>(ch, index, current, interpolationState[numAllocatedChannels + ch]) };
+        const float next { readDelayed<Mode, Interpolation>(ch, index, delaySamples, interpolationState[ch]) };
+        return previous + gain * (next - previous);
+    }
+
+    // Read channel ch at a fractional delay from write position index
+    // The delay is limited so the oldest tap stays in the buffer, and is not the sample just written at index
+    // for the policies with newer taps, as in readModulated a limited delay is read without interpolation
+    template<WrapMode Mode, typename Interpolation>
+    inline float readDelayed(unsigned int ch, unsigned int index, float delay, float& state) noexcept
+    {
+        const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+        const unsigned int maxDelay { getMaxSharedDelay<Interpolation>(Interpolation::NumNewerTaps > 0 ? 1u : 0u) };
+        const unsigned int integerDelay { static_cast<unsigned int>(delay) };
+        const unsigned int readDelay { std::min(std::max(integerDelay, Interpolation::NumNewerTaps), maxDelay) };
+        const float frac { integerDelay < maxDelay ? delay - static_cast<float>(integerDelay) : 0.f };
+        const unsigned int readIndex { wrap<Mode>(index + bufferSize - readDelay - olderTaps, bufferSize) };
+        return Interpolation::interpolate(&sample(ch, readIndex), sampleStride, frac, state);
+    }
+
+    template<WrapMode Mode, typename Interpolation>
+    void processModulated(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
+                          unsigned int numChannels, unsigned int numSamples);
+
+    template<WrapMode Mode, typename Interpolation>
+    void processModulated(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels);
+
+    // Implementation of the block read method above for one wrap mode
+    template<WrapMode Mode, typename Interpolation>
+    void readShared(Reader& reader, float* const* output, const float* const* modInput, unsigned int numChannels, unsigned int numSamples);
+
+    // Read channel ch with reader, modulated by mod, at write position index
+    // maxDelay keeps the oldest tap in the buffer, a delay limited to it is read without interpolation
+    // The delay is at most bufferSize - olderTaps, so the read index needs a single conditional wrap in both wrap modes
+    template<typename Interpolation>
+    inline float readModulated(Reader& reader, unsigned int ch, unsigned int index, float mod, unsigned int maxDelay) noexcept
+    {
+        const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+        // m is never negative, so truncation is the floor, and negative and NaN modulation give 0,
+        // without the library calls of std::fmax and std::floor
+        const float m { reader.delayFrac + (mod > 0.f ? mod : 0.f) };
+        const unsigned int mFloor { static_cast<unsigned int>(static_cast<int>(m)) };
+        const unsigned int delay { std::min(std::max(reader.delayInt + mFloor, Interpolation::NumNewerTaps), maxDelay) };
+        const float mFrac { delay < maxDelay ? m - static_cast<float>(mFloor) : 0.f };
+        const unsigned int readIndex { index + bufferSize - delay - olderTaps };
+        return Interpolation::interpolate(&sample(ch, readIndex >= bufferSize ? readIndex - bufferSize : readIndex), sampleStride, mFrac, reader.interpolationState[ch]);
+    }
+
+    // Longest delay a block of numSamples can be read with, so the oldest tap is not overwritten by the block
+    template<typename Interpolation>
+    unsigned int getMaxSharedDelay(unsigned int numSamples) const noexcept
+    {
+        const unsigned int olderTaps { Interpolation::NumTaps - 1 - Interpolation::NumNewerTaps };
+        return bufferSize > olderTaps + numSamples ? bufferSize - olderTaps - numSamples : Interpolation::NumNewerTaps;
+    }
+
+    // Implementation of processTaps and processTapOutputs
+    template<WrapMode Mode, typename Interpolation, bool SumTaps>
+    void processMultiTap(float* const* output, const float* const* input, const Tap* taps, unsigned int numTaps,
+                         unsigned int numChannels, unsigned int numSamples);
+
+    // Add count interpolated reads of one tap to acc, starting from the oldest tap sample at x
+    // Called with a literal stride of 1 for the Planar layout, so the loop vectorises
+    template<typename Interpolation>
+    static inline void accumulateTap(float* acc, const float* x, unsigned int stride, unsigned int count, float frac, float gain) noexcept
+    {
+        float state { 0.f };
+        for (unsigned int n = 0; n < count; ++n)
+            acc[n] += gain * Interpolation::interpolate(x + n * stride, stride, frac, state);
+    }
+
+    // Number of samples processed per multi tap chunk, the chunk input and sums live on the stack
+    static constexpr unsigned int TapChunkSize { 64 };
+
+    // Number of samples the modulated processing reads at once, as long as the
+    // modulated delays of the chunk stay in range, the taps of a chunk live on the stack
+    static constexpr unsigned int ModulatedChunkSize { 16 };
+
+    // Wrap an index into [0, bufferSize)
+    // In PowerOfTwo mode the unsigned overflow of index is harmless, as 2^32 is a multiple of bufferSize
+    template<WrapMode Mode>
+    static inline unsigned int wrap(unsigned int index, unsigned int bufferSize)
+    {
+        if constexpr (Mode == PowerOfTwo)
+            return index & (bufferSize - 1u);
+        else
+            return index % bufferSize;
+    }
+
+    // All channels in one aligned allocation of allocatedSize samples
+    std::unique_ptr<float[], AlignedDeleter> delayBuffer;
+    std::size_t allocatedSize { 0 };
+
+    unsigned int maxLengthSamples { 0 };
+    unsigned int numAllocatedChannels { 0 };
+    WrapMode wrapMode { Modulo };
+    Layout layout { Planar };
+
+    // Samples per channel and distance between neighbour channels and samples
+    // Planar: channelStride is bufferSize plus the guard zone rounded up to the alignment, sampleStride is 1
+    // Interleaved: channelStride is 1, sampleStride is the number of channels
+    unsigned int bufferSize { 0 };
+    unsigned int channelStride { 0 };
+    unsigned int sampleStride { 0 };
+
+    // State of the recursive interpolation policies, one per channel,
+    // followed by one per channel for the previous read position of crossfades
+    std::vector<float> interpolationState;
+
+    // Target delay time, split in integer and fractional parts
+    float delaySamples { 1.f };
+    unsigned int delayInt { 1 };
+    float delayFrac { 0.f };
+
+    // Delay changes, current is the delay being smoothed or the previous read position of a crossfade
+    // delayStep is the delay increment per sample when smoothing, the gain increment when crossfading
+    DelayUpdate delayUpdate { Jump };
+    unsigned int transitionSamples { 0 };
+    unsigned int transitionRemaining { 0 };
+    float currentDelay { 1.f };
+    float delayStep { 0.f };
     unsigned int writeIndex { 0 };
 };
 
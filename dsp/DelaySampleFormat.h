@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace mrta
+{
+
+// Compact sample formats for the CompactDelayLine storage
+// A format stores a float sample in a Type of half the size, encode and decode convert
+// arrays of samples with branchless element wise loops, which the compiler vectorises
+namespace DelaySampleFormat
+{
+
+// 16 bit fixed point, full scale is 1
+// Samples outside [-1, 1) are hard clipped, rounding to nearest adds a white noise floor of
+// about -101 dBFS RMS (an LSB of 2^-15), 98 dB below a full scale sine
+// The noise floor is absolute, so quiet repeats of long feedback delays get grainy,
+// like a 16 bit sampler or a tape loop
+struct Int16
+{
+    using Type = std::int16_t;
+
+    static inline Type encode(float x) noexcept
+    {
+        // Round to nearest in an offset range, where the truncation of the conversion is the floor
+        // The clipping also maps NaN to the most negative sample
+        const float offset { std::min(65535.f, std::max(0.f, x * 32768.f + 32768.5f)) };
+        return static_cast<Type>(static_cast<int>(offset) - 32768);
+    }
+
+    static inline float decode(Type x) noexcept
+    {
+        return static_cast<float>(x) * (1.f / 32768.f);
+    }
+
+    static inline void encode(Type* dst, const float* src, unsigned int count) noexcept
+    {
+        for (unsigned int n = 0; n < count; ++n)
+            dst[n] = encode(src[n]);
+    }
+
+    static inline void decode(float* dst, const Type* src, unsigned int count) noexcept
+    {
+        for (unsigned int n = 0; n < count; ++n)
+            dst[n] = decode(src[n]);
+    }
+};
+
+// IEEE 754 half precision, rounded to nearest even
+// 11 significant bits, so the error is relative to the signal: about 68 dB below it at
+// any level from 2^-14 (-84 dBFS) to the largest half, 65504. Below that the
+// step is a fixed 2^-24 (-144 dBFS). Nothing clips, feedback above 0 dBFS is kept
+// Infinities and NaNs are kept
+struct Half
+{
+    using Type = std::uint16_t;
+
+    static inline Type encode(float x) noexcept
+    {
+        const std::uint32_t bits { toBits(x) };
+        const std::uint32_t sign { bits & 0x80000000u };
+        const std::uint32_t f { bits ^ sign };
+
+        // Too large for a half, or infinity or NaN
+        const std::uint32_t overflow { f > 0x7f800000u ? 0x7e00u : 0x7c00u };
+
+        // Subnormal halves, rounded by the float addition of 0.5, which aligns the mantissa
+        const std::uint32_t subnormal { toBits(fromBits(f) + 0.5f) - 0x3f000000u };
+
+        // Normal halves, rebias the exponent and round the 13 dropped mantissa bits to nearest even
+        const std::uint32_t normal { (f + 0xc8000fffu + ((f >> 13) & 1u)) >> 13 };
+
+        const std::uint32_t h { select(f >= 0x47800000u, overflow, select(f < 0x38800000u, subnormal, normal)) };
+        return static_cast<Type>(h | (sign >> 16));
+    }
+
+    static inline float decode(Type x) noexcept
+    {
+        const std::uint32_t h { x };
+        const std::uint32_t shifted { (h & 0x7fffu) << 13 };
+        const std::uint32_t exponent { shifted & 0x0f800000u };
+
+        // Rebias the exponent, infinities and NaNs get the maximum float exponent
+        const std::uint32_t normal { shifted + select(exponent == 0x0f800000u, 0x70000000u, 0x38000000u) };
+
+        // Subnormal halves are renormalised by subtracting 2^-14 from a float with the same mantissa
+        const std::uint32_t subnormal { toBits(fromBits(shifted + 0x38800000u) - 6.103515625e-05f) };
+
+        return fromBits(select(exponent == 0, subnormal, normal) | ((h & 0x8000u) << 16));
+    }
+
+    static inline void encode(Type* dst, const float* src, unsigned int count) noexcept
+    {
+        for (unsigned int n = 0; n < count; ++n)
+            dst[n] = encode(src[n]);
+    }
+
+    static inline void decode(float* dst, const Type* src, unsigned int count) noexcept
+    {
+        for (unsigned int n = 0; n < count; ++n)
+            dst[n] = decode(src[n]);
+    }
+
+private:
+    static inline std::uint32_t toBits(float x) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    static inline float fromBits(std::uint32_t bits) noexcept
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    // Branchless select with a mask, so the conversion loops vectorise
+    static inline std::uint32_t select(bool condition, std::uint32_t a, std::uint32_t b) noexcept
+    {
+        const std::uint32_t mask { 0u - static_cast<std::uint32_t>(condition) };
+        return (a & mask) | (b & ~mask);
+    }
+};
+
+}
+
+}
@@ -0,0 +1,246 @@
+#include "FeedbackDelayNetwork.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Windows does not have Pi constants
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+namespace
+{
+
+bool isPrime(unsigned int x)
+{
+    if (x < 4)
+        return x > 1;
+
+    if (x % 2 == 0)
+        return false;
+
+    for (unsigned int d = 3; d * d <= x; d += 2)
+        if (x % d == 0)
+            return false;
+
+    return true;
+}
+
+// Longest line for a size in ms, the lines reach half an octave above the size,
+// plus some room for rounding up to a prime
+unsigned int getMaxLengthSamples(float sizeMs, double sampleRate)
+{
+    return static_cast<unsigned int>(std::ceil(std::fmax(sizeMs, 1.f) * std::sqrt(2.0) * 0.001 * sampleRate)) + 256;
+}
+
+}
+
+namespace mrta
+{
+
+FeedbackDelayNetwork::FeedbackDelayNetwork(float newMaxSizeMs, unsigned int newNumLines) :
+    delayLine(getMaxLengthSamples(newMaxSizeMs, sampleRate), MaxLines, DelayLine::Modulo, DelayLine::Interleaved),
+    damping(MaxLines)
+{
+    prepare(sampleRate, newMaxSizeMs);
+    setNumLines(newNumLines);
+}
+
+FeedbackDelayNetwork::~FeedbackDelayNetwork()
+{
+}
+
+void FeedbackDelayNetwork::prepare(double newSampleRate, float newMaxSizeMs)
+{
+    sampleRate = newSampleRate;
+    maxSizeMs = std::fmax(newMaxSizeMs, 1.f);
+    maxLengthSamples = getMaxLengthSamples(maxSizeMs, sampleRate);
+    sizeMs = std::fmin(sizeMs, maxSizeMs);
+
+    // Allocate for MaxLines first, so changing the number of lines later never allocates
+    delayLine.prepare(maxLengthSamples, MaxLines);
+    delayLine.prepare(maxLengthSamples, numLines);
+    damping.clear();
+
+    updateLines();
+}
+
+void FeedbackDelayNetwork::clear()
+{
+    delayLine.clear();
+    damping.clear();
+}
+
+void FeedbackDelayNetwork::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, MaxChannels);
+    if (numChannels == 0)
+        return;
+
+    if (numLines == 8)
+    {
+        if (matrix == Hadamard)
+            processLines<8, Hadamard>(output, input, numChannels, numSamples);
+        else
+            processLines<8, Householder>(output, input, numChannels, numSamples);
+    }
+    else
+    {
+        if (matrix == Hadamard)
+            processLines<MaxLines, Hadamard>(output, input, numChannels, numSamples);
+        else
+            processLines<MaxLines, Householder>(output, input, numChannels, numSamples);
+    }
+}
+
+template<unsigned int NumLines, FeedbackDelayNetwork::FeedbackMatrix Matrix>
+void FeedbackDelayNetwork::processLines(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    // Chunks are never longer than the shortest line, so a chunk only reads samples written before it
+    const unsigned int maxChunkSize { std::min(ChunkSize, minLineDelay) };
+
+    // The Hadamard transform is scaled to be orthogonal, the Householder reflection already is
+    const float matrixGain { Matrix == Hadamard ? 1.f / std::sqrt(static_cast<float>(NumLines)) : 1.f };
+
+    // Every output channel sums half of the lines, or all of them in mono
+    const float outputGain { 1.f / std::sqrt(static_cast<float>(NumLines)) };
+
+    // Mono feeds both halves of the lines
+    const float* inputLeft { input[0] };
+    const float* inputRight { input[numChannels - 1] };
+
+    float frames[ChunkSize * NumLines];
+
+    for (unsigned int n0 = 0; n0 < numSamples; n0 += maxChunkSize)
+    {
+        const unsigned int chunkSize { std::min(numSamples - n0, maxChunkSize) };
+
+        // Line outputs of the chunk, damped with the loop gains
+        delayLine.readInterleaved(frames, lineDelays, NumLines, chunkSize);
+        damping.processInterleaved(frames, frames, NumLines, chunkSize);
+
+        for (unsigned int n = 0; n < chunkSize; ++n)
+        {
+            float* x { frames + n * NumLines };
+
+            // Read the inputs before the outputs are written, they can be the same buffers
+            const float in[2] { inputLeft[n0 + n], inputRight[n0 + n] };
+
+            // Even lines to the left, odd lines to the right, with every other pair inverted
+            float out[2] { 0.f, 0.f };
+            for (unsigned int l = 0; l < NumLines; ++l)
+                out[l & 1u] += (l & 2u) ? -x[l] : x[l];
+
+            if (numChannels > 1)
+            {
+                output[0][n0 + n] = out[0] * outputGain;
+                output[1][n0 + n] = out[1] * outputGain;
+            }
+            else
+            {
+                output[0][n0 + n] = (out[0] + out[1]) * outputGain;
+            }
+
+            // Feed the lines back thru the matrix, plus the input
+            if constexpr (Matrix == Hadamard)
+                hadamard<NumLines>(x);
+            else
+                householder<NumLines>(x);
+
+            for (unsigned int l = 0; l < NumLines; ++l)
+                x[l] = x[l] * matrixGain + in[l & 1u];
+        }
+
+        delayLine.writeInterleaved(frames, NumLines, chunkSize);
+        delayLine.advance(chunkSize);
+    }
+}
+
+void FeedbackDelayNetwork::setNumLines(unsigned int newNumLines)
+{
+    newNumLines = newNumLines > 8 ? MaxLines : 8;
+    if (newNumLines == numLines)
+        return;
+
+    numLines = newNumLines;
+    delayLine.prepare(maxLengthSamples, numLines);
+    damping.clear();
+
+    updateLines();
+}
+
+void FeedbackDelayNetwork::setFeedbackMatrix(FeedbackMatrix newMatrix)
+{
+    matrix = newMatrix;
+}
+
+void FeedbackDelayNetwork::setSize(float newSizeMs)
+{
+    sizeMs = std::fmin(std::fmax(newSizeMs, 1.f), maxSizeMs);
+    updateLines();
+}
+
+void FeedbackDelayNetwork::setDecayTime(float newDecayTimeS)
+{
+    decayTimeS = std::fmax(newDecayTimeS, 0.01f);
+    updateDamping();
+}
+
+void FeedbackDelayNetwork::setDamping(float newDampingRatio)
+{
+    dampingRatio = std::fmin(std::fmax(newDampingRatio, 0.05f), 1.f);
+    updateDamping();
+}
+
+void FeedbackDelayNetwork::setDampingFrequency(float newDampingFreqHz)
+{
+    dampingFreqHz = std::fmax(newDampingFreqHz, 20.f);
+    updateDamping();
+}
+
+void FeedbackDelayNetwork::updateLines()
+{
+    // Lengths spread exponentially over an octave around the size, so the echoes do not pile up,
+    // each one rounded up to a prime larger than the previous one, so no two lines share a period
+    const double sizeSamples { sizeMs * 0.001 * sampleRate };
+    unsigned int previous { 1 };
+    for (unsigned int l = 0; l < numLines; ++l)
+    {
+        const double ratio { std::pow(2.0, (static_cast<double>(l) + 0.5) / static_cast<double>(numLines) - 0.5) };
+        unsigned int length { std::max(static_cast<unsigned int>(std::round(sizeSamples * ratio)), previous + 1) };
+        while (!isPrime(length) && length < maxLengthSamples)
+            ++length;
+
+        lineDelays[l] = std::min(length, maxLengthSamples);
+        previous = lineDelays[l];
+    }
+
+    minLineDelay = lineDelays[0];
+
+    updateDamping();
+}
+
+void FeedbackDelayNetwork::updateDamping()
+{
+    // First order shelf per line, with the gain that decays by 60 dB in the decay time
+    // over the length of the line at DC, and in the high frequency decay time at Nyquist
+    const double k { std::tan(M_PI * std::fmin(dampingFreqHz, static_cast<float>(0.45 * sampleRate)) / sampleRate) };
+    const double decaySamples { decayTimeS * sampleRate };
+    for (unsigned int l = 0; l < numLines; ++l)
+    {
+        const double delay { static_cast<double>(lineDelays[l]) };
+        const double gainLow { std::pow(10.0, -3.0 * delay / decaySamples) };
+        const double gainHigh { std::pow(10.0, -3.0 * delay / (decaySamples * dampingRatio)) };
+
+        const double a0 { 1.0 / (1.0 + k) };
+        const std::array<float, BiquadBank::CoeffsPerSection> coeffs { static_cast<float>((gainHigh + gainLow * k) * a0), // b0
+                                                                       static_cast<float>((gainLow * k - gainHigh) * a0), // b1
+                                                                       0.f, // b2
+                                                                       static_cast<float>((k - 1.0) * a0), // a1
+                                                                       0.f }; // a2
+        damping.setFilterCoeffs(coeffs, l);
+    }
+}
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "BiquadBank.h"
+#include "DelayLine.h"
+
+namespace mrta
+{
+
+// Feedback delay network reverb
+// The delay lines are the channels of one DelayLine with the Interleaved layout, so a sample of
+// all lines is one contiguous frame: every step of the loop (damping, feedback matrix, input and
+// output mixing) runs on frames and vectorises across the lines
+// Every line has a damping filter, a first order shelf as a BiquadBank filter, with the gains
+// for the decay times at low and high frequencies for the length of the line
+// Processing runs in chunks no longer than the shortest line, so the lines of a chunk are read,
+// filtered and mixed before the chunk is written back to them
+// Mono or stereo, the left channel feeds and reads the even lines, the right channel the odd ones
+// The output is the reverb only, without the dry signal
+class FeedbackDelayNetwork
+{
+public:
+    // Maximum number of delay lines
+    static constexpr unsigned int MaxLines { 16 };
+
+    // Maximum number of audio channels
+    static constexpr unsigned int MaxChannels { 2 };
+
+    enum FeedbackMatrix : unsigned int
+    {
+        // Scaled Hadamard matrix, every line feeds every line with the same gain and one of
+        // two signs, the densest mixing, applied as a fast Walsh-Hadamard transform
+        Hadamard = 0,
+
+        // Householder reflection, I - 2/N, every line feeds mostly itself and a little every other line,
+        // so the echo density builds up slower
+        Householder
+    };
+
+    FeedbackDelayNetwork(float maxSizeMs, unsigned int numLines);
+    ~FeedbackDelayNetwork();
+
+    // No default ctor
+    FeedbackDelayNetwork() = delete;
+
+    // No copy semantics
+    FeedbackDelayNetwork(const FeedbackDelayNetwork&) = delete;
+    const FeedbackDelayNetwork& operator=(const FeedbackDelayNetwork&) = delete;
+
+    // No move semantics
+    FeedbackDelayNetwork(FeedbackDelayNetwork&&) = delete;
+    const FeedbackDelayNetwork& operator=(FeedbackDelayNetwork&&) = delete;
+
+    // Update sample rate, reallocates and clear internal buffers
+    void prepare(double sampleRate, float maxSizeMs);
+
+    // Clear contents of internal buffers
+    void clear();
+
+    // Process audio, numChannels is limited to MaxChannels
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Set the number of delay lines, 8 or 16, values above 8 use 16
+    // Calling this method will clear the delay lines, it never allocates once prepared
+    void setNumLines(unsigned int newNumLines);
+
+    // Set the feedback matrix
+    void setFeedbackMatrix(FeedbackMatrix newMatrix);
+
+    // Set the mean length of the delay lines in ms, limited to the max size
+    // The lines are spread over an octave around it, with mutually prime lengths
+    // The read positions jump to the new lengths
+    void setSize(float newSizeMs);
+
+    // Set the time the reverb takes to decay by 60 dB at low frequencies, in seconds
+    void setDecayTime(float newDecayTimeS);
+
+    // Set the decay time at high frequencies, as a ratio of the decay time in [0.05, 1]
+    void setDamping(float newDampingRatio);
+
+    // Set the crossover frequency between the low and high frequency decay times in Hz
+    void setDampingFrequency(float newDampingFreqHz);
+
+    // return the current number of delay lines
+    unsigned int getNumLines() const noexcept { return numLines; }
+
+private:
+    // Number of frames processed at once, the frames of a chunk live on the stack
+    static constexpr unsigned int ChunkSize { 64 };
+
+    // Process all channels with NumLines lines and the Matrix feedback, unrolled over the lines
+    template<unsigned int NumLines, FeedbackMatrix Matrix>
+    void processLines(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Apply the feedback matrix to a frame of NumLines lines in place
+    // The Hadamard transform runs one stage of butterflies between lines Stride apart per call,
+    // the stride is a constant so every stage unrolls into a few vector operations
+    template<unsigned int NumLines, unsigned int Stride = 1>
+    static inline void hadamard(float* x) noexcept
+    {
+        for (unsigned int i = 0; i < NumLines; i += 2 * Stride)
+        {
+            for (unsigned int j = i; j < i + Stride; ++j)
+            {
+                const float a { x[j] };
+                const float b { x[j + Stride] };
+                x[j] = a + b;
+                x[j + Stride] = a - b;
+            }
+        }
+
+        if constexpr (2 * Stride < NumLines)
+            hadamard<NumLines, 2 * Stride>(x);
+    }
+
+    template<unsigned int NumLines>
+    static inline void householder(float* x) noexcept
+    {
+        float sum { 0.f };
+        for (unsigned int l = 0; l < NumLines; ++l)
+            sum += x[l];
+
+        const float reflection { sum * (2.f / static_cast<float>(NumLines)) };
+        for (unsigned int l = 0; l < NumLines; ++l)
+            x[l] -= reflection;
+    }
+
+    // Compute the line lengths for the current size, and the damping filters for them
+    void updateLines();
+    void updateDamping();
+
+    double sampleRate { 48000.0 };
+
+    mrta::DelayLine delayLine;
+    mrta::BiquadBank damping;
+
+    unsigned int numLines { 16 };
+    float maxSizeMs { 40.f };
+    unsigned int maxLengthSamples { 0 };
+    unsigned int lineDelays[MaxLines] { };
+    unsigned int minLineDelay { 1 };
+
+    FeedbackMatrix matrix { Hadamard };
+    float sizeMs { 40.f };
+    float decayTimeS { 2.f };
+    float dampingRatio { 0.5f };
+    float dampingFreqHz { 4000.f };
+};
+
+}
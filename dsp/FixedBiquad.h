@@ -0,0 +1,348 @@
+#pragma once
+
+#include "Biquad.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <utility>
+
+namespace mrta
+{
+
+// Biquad cascade with the number of sections and channels known at compile time
+// Storage is fixed size and the section cascade is fully unrolled, so the
+// coefficients and states of a channel are kept in registers for a whole block
+// Has the same interface as mrta::Biquad so both can be used interchangeably
+// Real is the type of the coefficients and states, as in mrta::BiquadCascade
+template<unsigned int NumSections, unsigned int MaxChannels, BiquadTopology Topology = BiquadTopology::DirectFormI, typename Real = float>
+class FixedBiquad
+{
+public:
+    static_assert(NumSections > 0, "FixedBiquad requires at least one section.");
+    static_assert(MaxChannels > 0, "FixedBiquad requires at least one channel.");
+
+    using CoeffType = Real;
+
+    static const unsigned int CoeffsPerSection = 5;
+    static const unsigned int StatesPerSection = Topology == BiquadTopology::DirectFormI ? 4 : 2;
+
+    FixedBiquad()
+    {
+        coeffs.fill({});
+        for (auto& seq : publishedSequence)
+            seq.store(0, std::memory_order_relaxed);
+
+        fetchedSequence.fill(0);
+        resetPublishedCoeffs();
+        clear();
+    }
+
+    // Mirrors the mrta::Biquad ctor, the number of sections is fixed by NumSections
+    // and the number of channels is limited to MaxChannels
+    FixedBiquad(unsigned int /*numSections*/, unsigned int maxNumChannels) :
+        FixedBiquad()
+    {
+        allocatedChannels = std::min(maxNumChannels, MaxChannels);
+    }
+
+    ~FixedBiquad() { }
+
+    // No copy semantics
+    FixedBiquad(const FixedBiquad&) = delete;
+    const FixedBiquad& operator=(const FixedBiquad&) = delete;
+
+    // No move semantics
+    FixedBiquad(FixedBiquad&&) = delete;
+    const FixedBiquad& operator=(FixedBiquad&&) = delete;
+
+    // Clear all states
+    // The first coeffs published afterwards are applied without interpolation
+    void clear()
+    {
+        for (auto& s : states)
+            s.fill(0);
+
+        interpolateCoeffs = false;
+    }
+
+    // Set the number of channels, limited to MaxChannels
+    // Storage is fixed so this never allocates, but it does clear the states
+    void reallocateChannels(unsigned int maxNumChannels)
+    {
+        allocatedChannels = std::min(maxNumChannels, MaxChannels);
+        clear();
+    }
+
+    // Change the number of channels in use, limited to MaxChannels
+    // Channels coming into use start from cleared states,
+    // the other channels keep their states
+    void setNumChannels(unsigned int numChannels)
+    {
+        numChannels = std::min(numChannels, MaxChannels);
+        for (unsigned int c = allocatedChannels; c < numChannels; ++c)
+            states[c].fill(0);
+
+        allocatedChannels = numChannels;
+    }
+
+    // Publish new target coeffs to a section, as in mrta::Biquad
+    // Lock-free, it can be called from any thread while process runs on the audio thread
+    // The next call to process interpolates the coeffs linearly across its block,
+    // from the current coeffs to the targets. Coeffs published after the states
+    // have been cleared (e.g. before the first process) are applied without interpolation
+    void setSectionCoeffs(const std::array<Real, CoeffsPerSection>& newSectionCoeffs, unsigned int section)
+    {
+        if (section >= NumSections)
+            return;
+
+        // Make the sequence odd, concurrent publishers of the same section wait for each other
+        // but the audio thread never waits on a publisher
+        std::atomic<unsigned int>& sequence { publishedSequence[section] };
+        unsigned int seq { sequence.load(std::memory_order_relaxed) & ~1u };
+        while (!sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            seq &= ~1u;
+
+        // The coeffs cannot be seen by the audio thread before the odd sequence
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+            publishedCoeffs[section * CoeffsPerSection + k].store(newSectionCoeffs[k], std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+        publishCount.fetch_add(1, std::memory_order_release);
+    }
+
+    // return the last coeffs set to a section, including the ones not yet fetched by process
+    // Must not be called concurrently with process
+    std::array<Real, CoeffsPerSection> getSectionCoeffs(unsigned int section) const
+    {
+        std::array<Real, CoeffsPerSection> c { };
+        if (section >= NumSections)
+            return c;
+
+        // Coeffs published after the last fetch are newer than the targets
+        if (publishedSequence[section].load(std::memory_order_acquire) != fetchedSequence[section])
+        {
+            for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+                c[k] = publishedCoeffs[section * CoeffsPerSection + k].load(std::memory_order_relaxed);
+        }
+        else
+        {
+            c = targetCoeffs[section];
+        }
+
+        return c;
+    }
+
+    // Process float or double audio
+    // This method can be called with a lower number of channels than allocated
+    template<typename Sample>
+    void process(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples)
+    {
+        numChannels = std::min(numChannels, allocatedChannels);
+
+        // Blocks without new coeffs run the cascade with constant coeffs
+        if (numSamples > 0 && fetchPublishedCoeffs(numSamples))
+        {
+            for (unsigned int c = 0; c < numChannels; ++c)
+                processChannel<true>(output[c], input[c], states[c], numSamples);
+
+            coeffs = targetCoeffs;
+            for (auto& s : coeffSteps)
+                s.fill(0);
+        }
+        else
+        {
+            for (unsigned int c = 0; c < numChannels; ++c)
+                processChannel<false>(output[c], input[c], states[c], numSamples);
+        }
+
+        interpolateCoeffs = true;
+    }
+
+    // return the number of currently allocated channels
+    unsigned int getAllocatedChannels() const noexcept { return allocatedChannels; }
+
+    // return the number of sections
+    unsigned int getAllocatedSections() const noexcept { return NumSections; }
+
+private:
+    using CoeffArray = std::array<std::array<Real, CoeffsPerSection>, NumSections>;
+    using ChannelStates = std::array<Real, NumSections * StatesPerSection>;
+
+    // Run the cascade over a block of a single channel
+    // When interpolating, the coeffs reach the targets on the last sample of the block
+    template<bool Interpolate, typename Sample>
+    void processChannel(Sample* output, const Sample* input, ChannelStates& channelStates, unsigned int numSamples) const
+    {
+        // Work on local copies so the compiler can keep them in registers
+        const CoeffArray localCoeffs { coeffs };
+        ChannelStates localStates { channelStates };
+
+        if constexpr (Interpolate)
+        {
+            const CoeffArray localSteps { coeffSteps };
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                const Real t { static_cast<Real>(n + 1) };
+                CoeffArray c;
+                for (unsigned int s = 0; s < NumSections; ++s)
+                    for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+                        c[s][k] = localCoeffs[s][k] + t * localSteps[s][k];
+
+                output[n] = static_cast<Sample>(processSections(static_cast<Real>(input[n]), c, localStates, std::make_integer_sequence<unsigned int, NumSections> {}));
+            }
+        }
+        else
+        {
+            for (unsigned int n = 0; n < numSamples; ++n)
+                output[n] = static_cast<Sample>(processSections(static_cast<Real>(input[n]), localCoeffs, localStates, std::make_integer_sequence<unsigned int, NumSections> {}));
+        }
+
+        channelStates = localStates;
+    }
+
+    // Read the coeffs published since the last block into the targets
+    // and set up the interpolation towards them over numSamples
+    // return true if any section has to be interpolated in this block
+    bool fetchPublishedCoeffs(unsigned int numSamples)
+    {
+        // Fast path, nothing was published since the last block
+        const unsigned int count { publishCount.load(std::memory_order_acquire) };
+        if (count == fetchedPublishCount)
+            return false;
+
+        bool fetchedAll { true };
+        bool interpolate { false };
+        const Real stepScale { Real { 1 } / static_cast<Real>(numSamples) };
+
+        for (unsigned int s = 0; s < NumSections; ++s)
+        {
+            const unsigned int seq { publishedSequence[s].load(std::memory_order_acquire) };
+            if (seq == fetchedSequence[s])
+                continue;
+
+            // A publisher is writing this section, try again on the next block
+            if (seq & 1u)
+            {
+                fetchedAll = false;
+                continue;
+            }
+
+            std::array<Real, CoeffsPerSection> c;
+            for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+                c[k] = publishedCoeffs[s * CoeffsPerSection + k].load(std::memory_order_relaxed);
+
+            // Discard the read if a publisher started writing in the meantime
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (publishedSequence[s].load(std::memory_order_relaxed) != seq)
+            {
+                fetchedAll = false;
+                continue;
+            }
+
+            fetchedSequence[s] = seq;
+            targetCoeffs[s] = c;
+            if (interpolateCoeffs)
+            {
+                for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+                    coeffSteps[s][k] = (targetCoeffs[s][k] - coeffs[s][k]) * stepScale;
+
+                interpolate = true;
+            }
+            else
+            {
+                coeffs[s] = c;
+            }
+        }
+
+        if (fetchedAll)
+            fetchedPublishCount = count;
+
+        return interpolate;
+    }
+
+    // Sync the targets and published coeffs to the current coeffs
+    void resetPublishedCoeffs()
+    {
+        targetCoeffs = coeffs;
+        for (auto& s : coeffSteps)
+            s.fill(0);
+
+        for (unsigned int s = 0; s < NumSections; ++s)
+            for (unsigned int k = 0; k < CoeffsPerSection; ++k)
+                publishedCoeffs[s * CoeffsPerSection + k].store(coeffs[s][k], std::memory_order_relaxed);
+
+        fetchedPublishCount = publishCount.load(std::memory_order_acquire);
+    }
+
+    // Run a single section of the cascade
+    template<unsigned int S>
+    static Real processSection(Real x, const CoeffArray& c, ChannelStates& st)
+    {
+        const unsigned int o { S * StatesPerSection };
+
+        if constexpr (Topology == BiquadTopology::DirectFormI)
+        {
+            Real acc { x * c[S][0] };
+            acc += c[S][1] * st[o + 0];
+            acc += c[S][2] * st[o + 1];
+            acc -= c[S][3] * st[o + 2];
+            acc -= c[S][4] * st[o + 3];
+
+            st[o + 1] = st[o + 0];
+            st[o + 0] = x;
+            st[o + 3] = st[o + 2];
+            st[o + 2] = acc;
+            return acc;
+        }
+        else
+        {
+            const Real y { x * c[S][0] + st[o + 0] };
+            st[o + 0] = x * c[S][1] - y * c[S][3] + st[o + 1];
+            st[o + 1] = x * c[S][2] - y * c[S][4];
+            return y;
+        }
+    }
+
+    // Unrolled cascade of all sections
+    template<unsigned int... S>
+    static Real processSections(Real x, const CoeffArray& c, ChannelStates& st, std::integer_sequence<unsigned int, S...>)
+    {
+        ((x = processSection<S>(x, c, st)), ...);
+        return x;
+    }
+
+    unsigned int allocatedChannels { MaxChannels };
+
+    // coeffs of all sections
+    // [[sos0_b0, sos0_b1, sos0_b2, sos0_a1, sos0_a2], [sos1_b0, ...], ...]
+    CoeffArray coeffs;
+
+    // Coeffs the current block moves towards and the per sample steps to reach them
+    CoeffArray targetCoeffs;
+    CoeffArray coeffSteps;
+
+    // Coeffs published by setSectionCoeffs, guarded per section by a sequence counter
+    // as in mrta::Biquad, odd while a publisher is writing
+    std::array<std::atomic<Real>, NumSections * CoeffsPerSection> publishedCoeffs;
+    std::array<std::atomic<unsigned int>, NumSections> publishedSequence;
+
+    // Incremented on every publish, lets process skip the sections
+    // when nothing was published since the last block
+    std::atomic<unsigned int> publishCount { 0 };
+
+    // Audio thread copies of the counters above at the last fetch
+    std::array<unsigned int, NumSections> fetchedSequence;
+    unsigned int fetchedPublishCount { 0 };
+
+    // Cleared along with the states, the first coeffs fetched afterwards are applied directly
+    bool interpolateCoeffs { false };
+
+    // states of all channels and sections, same per channel order as mrta::Biquad
+    // [[sos0_bz1, sos0_bz2, sos0_az1, sos0_az2, sos1_bz1, ...], ...]
+    std::array<ChannelStates, MaxChannels> states;
+};
+
+}
@@ -1,5 +1,6 @@
 #include "Flanger.h"
 
+#include <algorithm>
 #include <cmath>
 
 // Windows does not have Pi constants
@@ -11,11 +12,13 @@ namespace mrta
 {
 
 Flanger::Flanger(float maxTimeMs, unsigned int numChannels) :
-    delayLine(static_cast<unsigned int>(std::ceil(std::fmax(maxTimeMs, 1.f) * sampleRate)), numChannels),
+    delayLine(static_cast<unsigned int>(std::ceil(std::fmax(maxTimeMs, 1.f) * sampleRate)), numChannels, DelayLine::PowerOfTwo, DelayLine::Interleaved),
     offsetRamp(0.05f),
     modDepthRamp(0.05f),
     feedbackRamp(0.05f)
 {
+    for (auto& voice : voices)
+        voice.prepare(numChannels);
 }
 
 Flanger::~Flanger()
@@ -27,7 +30,11 @@ void Flanger::prepare(double newSampleRate, float maxTimeMs, unsigned int numCha
     sampleRate = newSampleRate;
 
     delayLine.prepare(static_cast<unsigned int>(std::round(maxTimeMs * static_cast<float>(0.001 * sampleRate))), numChannels);
-    delayLine.setDelaySamples(static_cast<unsigned int>(std::ceil(0.001 * sampleRate))); // Set fixed delay to 1ms
+    for (auto& voice : voices)
+    {
+        voice.prepare(numChannels);
+        voice.setDelaySamples(static_cast<float>(std::ceil(0.001 * sampleRate))); // Set fixed delay to 1ms
+    }
 
     offsetRamp.prepare(sampleRate, true, offsetMs * static_cast<float>(0.001 * sampleRate));
     modDepthRamp.prepare(sampleRate, true, modDepthMs * static_cast<float>(0.001 * sampleRate));
@@ -44,41 +51,57 @@ void Flanger::prepare(double newSampleRate, float maxTimeMs, unsigned int numCha
 void Flanger::clear()
 {
     delayLine.clear();
+    for (auto& voice : voices)
+        voice.clear();
+
     feedbackState[0] = 0.f;
     feedbackState[1] = 0.f;
 }
 
 void Flanger::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
 {
+    // Voices are spread evenly over the modulation period, and averaged
+    const float voicePhaseInc { static_cast<float>(2.0 * M_PI) / static_cast<float>(numVoices) };
+    const float voiceGain { 1.f / static_cast<float>(numVoices) };
+    const unsigned int numLfos { numVoices * numChannels };
+
     for (unsigned int n = 0; n < numSamples; ++n)
     {
-        // Process LFO acording to mod type
-        float lfo[2] { 0.f, 0.f };
-        switch (modType)
+        // Process LFO acording to mod type, for every voice and channel
+        float lfo[MaxVoices * 2] { };
+        for (unsigned int v = 0; v < numVoices; ++v)
         {
-        case Saw:
-            lfo[0] = phaseState[0] * static_cast<float>(0.5 / M_PI);
-            lfo[1] = phaseState[1] * static_cast<float>(0.5 / M_PI);
-            break;
-
-        case Tri:
-            lfo[0] = std::fabs((phaseState[0] - static_cast<float>(M_PI)) / static_cast<float>(M_PI));
-            lfo[1] = std::fabs((phaseState[1] - static_cast<float>(M_PI)) / static_cast<float>(M_PI));
-            break;
-
-        case Sin:
-            lfo[0] = 0.5f + 0.5f * std::sin(phaseState[0]);
-            lfo[1] = 0.5f + 0.5f * std::sin(phaseState[1]);
-            break;
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+            {
+                float phase { phaseState[ch] + static_cast<float>(v) * voicePhaseInc };
+                if (phase >= static_cast<float>(2 * M_PI))
+                    phase -= static_cast<float>(2 * M_PI);
+
+                float& voiceLfo { lfo[v * numChannels + ch] };
+                switch (modType)
+                {
+                case Saw:
+                    voiceLfo = phase * static_cast<float>(0.5 / M_PI);
+                    break;
+
+                case Tri:
+                    voiceLfo = std::fabs((phase - static_cast<float>(M_PI)) / static_cast<float>(M_PI));
+                    break;
+
+                case Sin:
+                    voiceLfo = 0.5f + 0.5f * std::sin(phase);
+                    break;
+                }
+            }
         }
 
         // Increment and wrap phase states
         phaseState[0] = std::fmod(phaseState[0] + phaseInc, static_cast<float>(2 * M_PI));
         phaseState[1] = std::fmod(phaseState[1] + phaseInc, static_cast<float>(2 * M_PI));
 
-        // Apply mod depth and offset ramps
-        modDepthRamp.applyGain(lfo, numChannels);
-        offsetRamp.applySum(lfo, numChannels);
+        // Apply mod depth and offset ramps, to all voices at once
+        modDepthRamp.applyGain(lfo, numLfos);
+        offsetRamp.applySum(lfo, numLfos);
 
         // Process feedback gain ramp
         feedbackRamp.applyGain(feedbackState, numChannels);
@@ -88,12 +111,24 @@ void Flanger::process(float* const* output, const float* const* input, unsigned
         for (unsigned int ch = 0; ch < numChannels; ++ch)
             x[ch] = input[ch][n] + feedbackState[ch];
 
-        // Process delay
-        delayLine.process(feedbackState, x, lfo, numChannels);
+        // Write the input once, every voice reads it with its own modulation
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            delayLine.write(ch, x[ch]);
+
+        // Cubic interpolation avoids the high frequency loss of linear interpolation
+        float y[2] { 0.f, 0.f };
+        for (unsigned int v = 0; v < numVoices; ++v)
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                y[ch] += delayLine.readInterpolated<DelayInterpolation::Lagrange3>(voices[v], ch, lfo[v * numChannels + ch]);
+
+        delayLine.advance();
 
         // Write to output buffers
         for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            feedbackState[ch] = y[ch] * voiceGain;
             output[ch][n] = feedbackState[ch];
+        }
     }
 }
 
@@ -128,4 +163,9 @@ void Flanger::setModulationType(ModulationType newModType)
     modType = newModType;
 }
 
+void Flanger::setNumVoices(unsigned int newNumVoices)
+{
+    numVoices = std::min(std::max(newNumVoices, 1u), MaxVoices);
+}
+
 }
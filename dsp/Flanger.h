@@ -9,6 +9,9 @@ namespace mrta
 class Flanger
 {
 public:
+    // Maximum number of voices reading the delay line
+    static constexpr unsigned int MaxVoices { 4 };
+
     enum ModulationType : unsigned int
     {
         Sin = 0,
@@ -54,10 +57,16 @@ public:
     // Set delay time modulation waveform type
     void setModulationType(ModulationType newModType);
 
+    // Set the number of voices, limited to [1, MaxVoices]
+    // The voices share one delay line, their modulation phases are spread evenly over the
+    // modulation period and their outputs are averaged, a single voice is the classic flanger
+    void setNumVoices(unsigned int newNumVoices);
+
 private:
     double sampleRate { 48000.0 };
 
     mrta::DelayLine delayLine;
+    mrta::DelayLine::Reader voices[MaxVoices];
 
     mrta::Ramp<float> offsetRamp;
     mrta::Ramp<float> modDepthRamp;
@@ -73,6 +82,8 @@ private:
 
     ModulationType modType { Sin };
 
+    unsigned int numVoices { 1 };
+
     float feedbackState[2] { 0.f, 0.f };
 };
 
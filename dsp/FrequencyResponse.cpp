@@ -0,0 +1,181 @@
+#include "FrequencyResponse.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mrta
+{
+
+FrequencyResponse::FrequencyResponse(unsigned int newNumSections, unsigned int newMaxNumFrequencies)
+{
+    reallocate(newNumSections, newMaxNumFrequencies);
+}
+
+FrequencyResponse::FrequencyResponse()
+{
+}
+
+FrequencyResponse::~FrequencyResponse()
+{
+}
+
+void FrequencyResponse::reallocate(unsigned int newNumSections, unsigned int newMaxNumFrequencies)
+{
+    numSections = newNumSections;
+    maxNumFrequencies = newMaxNumFrequencies;
+    numFrequencies = 0;
+
+    frequencies.assign(maxNumFrequencies, 0.f);
+    versin1.assign(maxNumFrequencies, 0.f);
+    sin1.assign(maxNumFrequencies, 0.f);
+    versin2.assign(maxNumFrequencies, 0.f);
+    sin2.assign(maxNumFrequencies, 0.f);
+
+    coeffs.assign(numSections, { 1.0, 0.0, 0.0, 0.0, 0.0 });
+    sectionChanged.assign(numSections, 1);
+    anySectionChanged = true;
+
+    sectionReal.assign(numSections * maxNumFrequencies, 1.f);
+    sectionImag.assign(numSections * maxNumFrequencies, 0.f);
+    responseReal.assign(maxNumFrequencies, 1.f);
+    responseImag.assign(maxNumFrequencies, 0.f);
+}
+
+void FrequencyResponse::setFrequencies(const float* newFrequencies, unsigned int newNumFrequencies, double sampleRate)
+{
+    numFrequencies = std::min(newNumFrequencies, maxNumFrequencies);
+
+    const double radPerHz { 2.0 * std::acos(-1.0) / std::fmax(sampleRate, 1.0) };
+    for (unsigned int f = 0; f < numFrequencies; ++f)
+    {
+        const double w { radPerHz * newFrequencies[f] };
+        const double sinHalf { std::sin(0.5 * w) };
+        const double sinFull { std::sin(w) };
+        frequencies[f] = newFrequencies[f];
+        versin1[f] = static_cast<float>(2.0 * sinHalf * sinHalf);
+        sin1[f] = static_cast<float>(sinFull);
+        versin2[f] = static_cast<float>(2.0 * sinFull * sinFull);
+        sin2[f] = static_cast<float>(std::sin(2.0 * w));
+    }
+
+    std::fill(sectionChanged.begin(), sectionChanged.end(), 1);
+    anySectionChanged = true;
+}
+
+void FrequencyResponse::setLogFrequencies(float minFrequency, float maxFrequency, unsigned int newNumFrequencies, double sampleRate)
+{
+    newNumFrequencies = std::min(newNumFrequencies, maxNumFrequencies);
+    minFrequency = std::fmax(minFrequency, 1e-3f);
+    maxFrequency = std::fmax(maxFrequency, minFrequency);
+
+    // Built in place, setFrequencies then only reads each entry before writing it
+    const double ratio { static_cast<double>(maxFrequency) / minFrequency };
+    for (unsigned int f = 0; f < newNumFrequencies; ++f)
+    {
+        const double t { newNumFrequencies > 1 ? static_cast<double>(f) / (newNumFrequencies - 1) : 0.0 };
+        frequencies[f] = static_cast<float>(minFrequency * std::pow(ratio, t));
+    }
+
+    setFrequencies(frequencies.data(), newNumFrequencies, sampleRate);
+}
+
+void FrequencyResponse::setSectionCoeffs(const std::array<double, CoeffsPerSection>& newSectionCoeffs, unsigned int section)
+{
+    if (section < numSections && newSectionCoeffs != coeffs[section])
+    {
+        coeffs[section] = newSectionCoeffs;
+        sectionChanged[section] = 1;
+        anySectionChanged = true;
+    }
+}
+
+void FrequencyResponse::update()
+{
+    if (!anySectionChanged)
+        return;
+
+    for (unsigned int s = 0; s < numSections; ++s)
+    {
+        if (sectionChanged[s])
+        {
+            evaluateSection(s);
+            sectionChanged[s] = 0;
+        }
+    }
+
+    // Product of all sections
+    float* re { responseReal.data() };
+    float* im { responseImag.data() };
+    std::fill(re, re + numFrequencies, 1.f);
+    std::fill(im, im + numFrequencies, 0.f);
+
+    for (unsigned int s = 0; s < numSections; ++s)
+    {
+        const float* sre { sectionReal.data() + s * maxNumFrequencies };
+        const float* sim { sectionImag.data() + s * maxNumFrequencies };
+        for (unsigned int f = 0; f < numFrequencies; ++f)
+        {
+            const float r { re[f] * sre[f] - im[f] * sim[f] };
+            const float i { re[f] * sim[f] + im[f] * sre[f] };
+            re[f] = r;
+            im[f] = i;
+        }
+    }
+
+    anySectionChanged = false;
+}
+
+void FrequencyResponse::evaluateSection(unsigned int section)
+{
+    const std::array<double, CoeffsPerSection>& c { coeffs[section] };
+    const float b1 { static_cast<float>(c[1]) };
+    const float b2 { static_cast<float>(c[2]) };
+    const float a1 { static_cast<float>(c[3]) };
+    const float a2 { static_cast<float>(c[4]) };
+
+    // Responses at DC, summed in double since they often nearly cancel (e.g. low shelves and peaks)
+    const float numDC { static_cast<float>(c[0] + c[1] + c[2]) };
+    const float denDC { static_cast<float>(1.0 + c[3] + c[4]) };
+
+    const float* v1 { versin1.data() };
+    const float* s1 { sin1.data() };
+    const float* v2 { versin2.data() };
+    const float* s2 { sin2.data() };
+    float* re { sectionReal.data() + section * maxNumFrequencies };
+    float* im { sectionImag.data() + section * maxNumFrequencies };
+
+    // H(e^jw) = (b0 + b1 e^-jw + b2 e^-2jw) / (1 + a1 e^-jw + a2 e^-2jw)
+    // with cos(w) = 1 - versin(w), which keeps the precision at low frequencies
+    for (unsigned int f = 0; f < numFrequencies; ++f)
+    {
+        const float numRe { numDC - b1 * v1[f] - b2 * v2[f] };
+        const float numIm { -(b1 * s1[f] + b2 * s2[f]) };
+        const float denRe { denDC - a1 * v1[f] - a2 * v2[f] };
+        const float denIm { -(a1 * s1[f] + a2 * s2[f]) };
+        const float denNorm { 1.f / (denRe * denRe + denIm * denIm) };
+
+        re[f] = (numRe * denRe + numIm * denIm) * denNorm;
+        im[f] = (numIm * denRe - numRe * denIm) * denNorm;
+    }
+}
+
+void FrequencyResponse::getMagnitude(float* magnitude) const
+{
+    for (unsigned int f = 0; f < numFrequencies; ++f)
+        magnitude[f] = std::sqrt(responseReal[f] * responseReal[f] + responseImag[f] * responseImag[f]);
+}
+
+void FrequencyResponse::getMagnitudeDecibels(float* magnitudeDecibels) const
+{
+    // 10 log10 of the squared magnitude, floored to avoid -inf at the zeros
+    for (unsigned int f = 0; f < numFrequencies; ++f)
+        magnitudeDecibels[f] = 10.f * std::log10(std::fmax(responseReal[f] * responseReal[f] + responseImag[f] * responseImag[f], 1e-20f));
+}
+
+void FrequencyResponse::getPhase(float* phase) const
+{
+    for (unsigned int f = 0; f < numFrequencies; ++f)
+        phase[f] = std::atan2(responseImag[f], responseReal[f]);
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+namespace mrta
+{
+
+// Complex frequency response of a cascade of biquad sections on a grid of frequencies
+// The trigonometric terms of the grid are cached when the grid is set, and the response of every
+// section is cached as well, so a new evaluation only recomputes the sections whose
+// coeffs changed plus the product of all sections
+// All loops run over the frequencies on separate real and imaginary arrays,
+// so they vectorise across frequencies
+class FrequencyResponse
+{
+public:
+    static const unsigned int CoeffsPerSection = 5;
+
+    FrequencyResponse(unsigned int numSections, unsigned int maxNumFrequencies);
+    FrequencyResponse();
+    ~FrequencyResponse();
+
+    // No copy semantics
+    FrequencyResponse(const FrequencyResponse&) = delete;
+    const FrequencyResponse& operator=(const FrequencyResponse&) = delete;
+
+    // No move semantics
+    FrequencyResponse(FrequencyResponse&&) = delete;
+    const FrequencyResponse& operator=(FrequencyResponse&&) = delete;
+
+    // Reallocate storage for numSections and up to maxNumFrequencies
+    // Calling this method will reset all sections to a pass-thru and clear the frequency grid
+    void reallocate(unsigned int numSections, unsigned int maxNumFrequencies);
+
+    // Set the frequency grid in Hz, limited to maxNumFrequencies
+    // All sections are evaluated again on the next update
+    void setFrequencies(const float* frequencies, unsigned int numFrequencies, double sampleRate);
+
+    // Set a grid of numFrequencies log spaced frequencies from minFrequency to maxFrequency in Hz
+    void setLogFrequencies(float minFrequency, float maxFrequency, unsigned int numFrequencies, double sampleRate);
+
+    // Set new coeffs to a section, same convention as Biquad::setSectionCoeffs
+    // Coeffs are taken in double so the response of double precision filters is exact as well
+    // The section is only evaluated again on the next update if the coeffs are different
+    void setSectionCoeffs(const std::array<double, CoeffsPerSection>& newSectionCoeffs, unsigned int section);
+
+    // Evaluate the sections that changed since the last update and the response of the cascade
+    void update();
+
+    // Magnitude of the cascade response at every frequency, linear or in dB
+    void getMagnitude(float* magnitude) const;
+    void getMagnitudeDecibels(float* magnitudeDecibels) const;
+
+    // Phase of the cascade response at every frequency in radians, in [-pi, pi]
+    void getPhase(float* phase) const;
+
+    // Real and imaginary parts of the cascade response at every frequency
+    const float* getReal() const noexcept { return responseReal.data(); }
+    const float* getImag() const noexcept { return responseImag.data(); }
+
+    // return the frequencies of the grid in Hz
+    const float* getFrequencies() const noexcept { return frequencies.data(); }
+
+    // return the number of frequencies of the grid
+    unsigned int getNumFrequencies() const noexcept { return numFrequencies; }
+
+    // return the number of sections
+    unsigned int getNumSections() const noexcept { return numSections; }
+
+private:
+    // Evaluate the response of one section on the whole grid
+    void evaluateSection(unsigned int section);
+
+    unsigned int numSections { 0 };
+    unsigned int numFrequencies { 0 };
+    unsigned int maxNumFrequencies { 0 };
+
+    // Frequency grid in Hz and the versine (1 - cos) / sin of w and 2w, w in rad/sample
+    std::vector<float> frequencies;
+    std::vector<float> versin1, sin1, versin2, sin2;
+
+    // coeffs of all sections, with a flag for the sections to evaluate on the next update
+    std::vector<std::array<double, CoeffsPerSection>> coeffs;
+    std::vector<unsigned char> sectionChanged;
+    bool anySectionChanged { false };
+
+    // Response of every section, numFrequencies values per section
+    // [sos0_f0, sos0_f1, ... , sos1_f0, sos1_f1, ...]
+    std::vector<float> sectionReal, sectionImag;
+
+    // Response of the cascade
+    std::vector<float> responseReal, responseImag;
+};
+
+}
@@ -0,0 +1,228 @@
+#include "ParallelBiquad.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace mrta
+{
+
+ParallelBiquad::ParallelBiquad(unsigned int maxNumSections, unsigned int maxNumChannels)
+{
+    reallocate(maxNumSections, maxNumChannels);
+}
+
+ParallelBiquad::ParallelBiquad()
+{
+}
+
+ParallelBiquad::~ParallelBiquad()
+{
+}
+
+void ParallelBiquad::clear()
+{
+    for (auto& s : states)
+        std::fill(s.begin(), s.end(), 0.f);
+}
+
+void ParallelBiquad::reallocate(unsigned int maxNumSections, unsigned int maxNumChannels)
+{
+    allocatedSections = maxNumSections;
+    allocatedChannels = maxNumChannels;
+    numSections = 0;
+    directGain = 0.f;
+
+    const unsigned int stride { ((allocatedSections + LaneWidth - 1) / LaneWidth) * LaneWidth };
+    for (auto& c : coeffs)
+        c.assign(stride, 0.f);
+
+    for (auto& s : states)
+        s.assign(stride * allocatedChannels, 0.f);
+}
+
+bool ParallelBiquad::setCascade(const std::vector<std::array<float, CoeffsPerSection>>& cascadeCoeffs)
+{
+    std::vector<std::array<float, ParallelCoeffsPerSection>> parallelCoeffs;
+    float newDirectGain { 0.f };
+    if (!convert(cascadeCoeffs, parallelCoeffs, newDirectGain) || parallelCoeffs.size() > allocatedSections)
+        return false;
+
+    // Unused sections are zeroed, they never leave their cleared states
+    for (auto& c : coeffs)
+        std::fill(c.begin(), c.end(), 0.f);
+
+    numSections = static_cast<unsigned int>(parallelCoeffs.size());
+    for (unsigned int s = 0; s < numSections; ++s)
+        for (unsigned int k = 0; k < ParallelCoeffsPerSection; ++k)
+            coeffs[k][s] = parallelCoeffs[s][k];
+
+    directGain = newDirectGain;
+    clear();
+    return true;
+}
+
+bool ParallelBiquad::setCascade(const Biquad& cascade)
+{
+    std::vector<std::array<float, CoeffsPerSection>> cascadeCoeffs(cascade.getAllocatedSections());
+    for (unsigned int s = 0; s < cascadeCoeffs.size(); ++s)
+        cascadeCoeffs[s] = cascade.getSectionCoeffs(s);
+
+    return setCascade(cascadeCoeffs);
+}
+
+void ParallelBiquad::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, allocatedChannels);
+
+    const unsigned int numGroups { getNumPaddedSections() / LaneWidth };
+    const unsigned int stride { static_cast<unsigned int>(coeffs[0].size()) };
+
+    // Lane sums of every sample of a chunk, reduced to the output once all groups ran
+    float acc[ChunkSize][LaneWidth];
+
+    for (unsigned int c = 0; c < numChannels; ++c)
+    {
+        float* s1 { states[0].data() + c * stride };
+        float* s2 { states[1].data() + c * stride };
+
+        for (unsigned int n0 = 0; n0 < numSamples; n0 += ChunkSize)
+        {
+            const unsigned int chunkSize { std::min(numSamples - n0, ChunkSize) };
+            const float* x { input[c] + n0 };
+
+            for (unsigned int n = 0; n < chunkSize; ++n)
+                for (unsigned int l = 0; l < LaneWidth; ++l)
+                    acc[n][l] = 0.f;
+
+            for (unsigned int g = 0; g < numGroups; ++g)
+            {
+                const unsigned int o { g * LaneWidth };
+                const float* const groupCoeffs[ParallelCoeffsPerSection] { coeffs[0].data() + o, coeffs[1].data() + o, coeffs[2].data() + o, coeffs[3].data() + o };
+                processGroup(acc, x, chunkSize, groupCoeffs, s1 + o, s2 + o);
+            }
+
+            // The input of the chunk is not read anymore, so processing in-place is fine
+            float* y { output[c] + n0 };
+            for (unsigned int n = 0; n < chunkSize; ++n)
+            {
+                float sum { directGain * x[n] };
+                for (unsigned int l = 0; l < LaneWidth; ++l)
+                    sum += acc[n][l];
+
+                y[n] = sum;
+            }
+        }
+    }
+}
+
+bool ParallelBiquad::convert(const std::vector<std::array<float, CoeffsPerSection>>& cascadeCoeffs,
+                             std::vector<std::array<float, ParallelCoeffsPerSection>>& parallelCoeffs,
+                             float& directGain)
+{
+    using Complex = std::complex<double>;
+
+    // Sections kept and their poles, roots of z^2 + a1 z + a2
+    std::vector<std::array<double, CoeffsPerSection>> sections;
+    std::vector<Complex> poles;
+    double d0 { 1.0 };
+    for (const auto& c : cascadeCoeffs)
+    {
+        if (Biquad::isIdentity(c))
+            continue;
+
+        if (c[4] == 0.f)
+            return false;
+
+        const std::array<double, CoeffsPerSection> sos { c[0], c[1], c[2], c[3], c[4] };
+        const Complex disc { std::sqrt(Complex(sos[3] * sos[3] - 4.0 * sos[4])) };
+        poles.push_back(0.5 * (-sos[3] + disc));
+        poles.push_back(0.5 * (-sos[3] - disc));
+        sections.push_back(sos);
+
+        // H(z) for z -> 0 is the product of b2 / a2, the partial fractions all vanish there
+        d0 *= sos[2] / sos[4];
+    }
+
+    for (unsigned int i = 0; i < poles.size(); ++i)
+        for (unsigned int j = i + 1; j < poles.size(); ++j)
+            if (std::abs(poles[i] - poles[j]) < MinPoleDistance)
+                return false;
+
+    // Residue of every pole, r_k = (1 - p_k z^-1) H(z) at z = p_k
+    std::vector<Complex> residues(poles.size());
+    for (unsigned int k = 0; k < poles.size(); ++k)
+    {
+        const Complex w { 1.0 / poles[k] };
+        Complex r { 1.0 };
+        for (const auto& sos : sections)
+            r *= sos[0] + w * (sos[1] + w * sos[2]);
+
+        for (unsigned int j = 0; j < poles.size(); ++j)
+            if (j != k)
+                r /= 1.0 - poles[j] * w;
+
+        residues[k] = r;
+    }
+
+    // Pair back the two poles of each section
+    // r1 / (1 - p1 z^-1) + r2 / (1 - p2 z^-1) = (r1 + r2 - (r1 p2 + r2 p1) z^-1) / (1 + a1 z^-1 + a2 z^-2)
+    // The poles are real or complex conjugates, and so are their residues, so both numerator coeffs are real
+    parallelCoeffs.resize(sections.size());
+    for (unsigned int s = 0; s < sections.size(); ++s)
+    {
+        const Complex& p1 { poles[2 * s] };
+        const Complex& p2 { poles[2 * s + 1] };
+        const Complex& r1 { residues[2 * s] };
+        const Complex& r2 { residues[2 * s + 1] };
+
+        parallelCoeffs[s] = { static_cast<float>((r1 + r2).real()),
+                              static_cast<float>(-(r1 * p2 + r2 * p1).real()),
+                              static_cast<float>(sections[s][3]),
+                              static_cast<float>(sections[s][4]) };
+    }
+
+    directGain = static_cast<float>(d0);
+    return true;
+}
+
+double ParallelBiquad::getResponseError(const std::vector<std::array<float, CoeffsPerSection>>& cascadeCoeffs,
+                                        const std::vector<std::array<float, ParallelCoeffsPerSection>>& parallelCoeffs,
+                                        float directGain,
+                                        unsigned int numFrequencies)
+{
+    using Complex = std::complex<double>;
+
+    const double pi { std::acos(-1.0) };
+    const double minFrequency { 1e-4 * pi };
+    double maxError { 0.0 };
+    double maxMagnitude { 0.0 };
+
+    for (unsigned int i = 0; i < numFrequencies; ++i)
+    {
+        const double t { numFrequencies > 1 ? static_cast<double>(i) / static_cast<double>(numFrequencies - 1) : 1.0 };
+        const double omega { minFrequency * std::pow(pi / minFrequency, t) };
+        const Complex w { std::polar(1.0, -omega) };
+
+        Complex cascade { 1.0 };
+        for (const auto& c : cascadeCoeffs)
+        {
+            const double b0 { c[0] }, b1 { c[1] }, b2 { c[2] }, a1 { c[3] }, a2 { c[4] };
+            cascade *= (b0 + w * (b1 + w * b2)) / (1.0 + w * (a1 + w * a2));
+        }
+
+        Complex parallel { directGain };
+        for (const auto& c : parallelCoeffs)
+        {
+            const double b0 { c[0] }, b1 { c[1] }, a1 { c[2] }, a2 { c[3] };
+            parallel += (b0 + w * b1) / (1.0 + w * (a1 + w * a2));
+        }
+
+        maxError = std::fmax(maxError, std::abs(parallel - cascade));
+        maxMagnitude = std::fmax(maxMagnitude, std::abs(cascade));
+    }
+
+    return maxMagnitude > 0.0 ? maxError / maxMagnitude : maxError;
+}
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Biquad.h"
+
+#include <array>
+#include <vector>
+
+namespace mrta
+{
+
+// Parallel form of a biquad cascade
+// The cascade H(z) = prod_i (b0_i + b1_i z^-1 + b2_i z^-2) / (1 + a1_i z^-1 + a2_i z^-2)
+// is expanded in partial fractions as
+// H(z) = d0 + sum_i (beta0_i + beta1_i z^-1) / (1 + a1_i z^-1 + a2_i z^-2)
+// Each section keeps the poles of one cascade section, so the sections do not depend
+// on each other and LaneWidth of them are processed together in one vectorised step
+//
+// Accuracy: the expansion is computed in double precision and is exact up to rounding,
+// the error comes from the float coeffs and states of the parallel sections. The residues grow as
+// 1 / (distance between poles), so poles that are close to each other (e.g. narrow
+// bands at nearby low frequencies, where all poles crowd near z = 1) produce large
+// residues that cancel in the sum and lose precision. Repeated poles (e.g. two equal
+// sections, as in Linkwitz-Riley crossovers) have no partial fraction expansion of this
+// form and the conversion fails. Use getResponseError to check a conversion before using it
+class ParallelBiquad
+{
+public:
+    static const unsigned int CoeffsPerSection = Biquad::CoeffsPerSection;
+    static const unsigned int LaneWidth = Biquad::LaneWidth;
+
+    // Coeffs of a parallel section [beta0, beta1, a1, a2]
+    static const unsigned int ParallelCoeffsPerSection = 4;
+
+    // Poles closer than this are considered repeated and the conversion fails
+    static constexpr double MinPoleDistance { 1e-6 };
+
+    ParallelBiquad(unsigned int maxNumSections, unsigned int maxNumChannels);
+    ParallelBiquad();
+    ~ParallelBiquad();
+
+    // No copy semantics
+    ParallelBiquad(const ParallelBiquad&) = delete;
+    const ParallelBiquad& operator=(const ParallelBiquad&) = delete;
+
+    // No move semantics
+    ParallelBiquad(ParallelBiquad&&) = delete;
+    const ParallelBiquad& operator=(ParallelBiquad&&) = delete;
+
+    // Clear all states
+    void clear();
+
+    // Reallocate coefficient and state storage for up to maxNumSections cascade sections
+    // Calling this method will clear the coefficients and states, the filter outputs silence
+    void reallocate(unsigned int maxNumSections, unsigned int maxNumChannels);
+
+    // Convert a cascade and load its parallel form, clearing the states
+    // Sections equal to an identity are skipped
+    // Not real-time safe, the conversion allocates
+    // return false and leave the filter unchanged if the cascade cannot be converted
+    // or has more sections than allocated
+    bool setCascade(const std::vector<std::array<float, CoeffsPerSection>>& cascadeCoeffs);
+
+    // Same as above, converting the sections in use of a Biquad
+    bool setCascade(const Biquad& cascade);
+
+    // Process audio
+    // This method can be called with a lower number of channels than allocated
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // return the number of currently allocated channels
+    unsigned int getAllocatedChannels() const noexcept { return allocatedChannels; }
+
+    // return the number of parallel sections in use
+    unsigned int getNumSections() const noexcept { return numSections; }
+
+    // Offline converter from cascade to parallel form
+    // Sections equal to an identity are skipped
+    // return false if a section has a pole at the origin (a2 == 0) or two poles
+    // are closer than MinPoleDistance
+    static bool convert(const std::vector<std::array<float, CoeffsPerSection>>& cascadeCoeffs,
+                        std::vector<std::array<float, ParallelCoeffsPerSection>>& parallelCoeffs,
+                        float& directGain);
+
+    // Largest difference between the responses of a cascade and its parallel form,
+    // relative to the peak magnitude of the cascade response
+    // Evaluated in double precision on numFrequencies log spaced normalised
+    // frequencies from 1e-4 * pi to pi rad/sample
+    static double getResponseError(const std::vector<std::array<float, CoeffsPerSection>>& cascadeCoeffs,
+                                   const std::vector<std::array<float, ParallelCoeffsPerSection>>& parallelCoeffs,
+                                   float directGain,
+                                   unsigned int numFrequencies = 512);
+
+private:
+    // Number of samples processed per chunk, the lane sums of a chunk live on the stack
+    static const unsigned int ChunkSize = 64;
+
+    // Run one group of LaneWidth sections over a chunk of samples of one channel,
+    // adding the section outputs lane by lane to acc
+    // The states are kept in locals for the whole chunk
+    static inline void processGroup(float (&acc)[ChunkSize][LaneWidth], const float* x, unsigned int chunkSize,
+                                    const float* const (&c)[ParallelCoeffsPerSection], float* s1, float* s2)
+    {
+        float b0[LaneWidth], b1[LaneWidth], a1[LaneWidth], a2[LaneWidth];
+        float st1[LaneWidth], st2[LaneWidth];
+        for (unsigned int l = 0; l < LaneWidth; ++l)
+        {
+            b0[l] = c[0][l];
+            b1[l] = c[1][l];
+            a1[l] = c[2][l];
+            a2[l] = c[3][l];
+            st1[l] = s1[l];
+            st2[l] = s2[l];
+        }
+
+        // Transposed Direct Form II, there is no b2 in the parallel sections
+        for (unsigned int n = 0; n < chunkSize; ++n)
+        {
+            const float xn { x[n] };
+            float* accn { acc[n] };
+            for (unsigned int l = 0; l < LaneWidth; ++l)
+            {
+                const float y { xn * b0[l] + st1[l] };
+                st1[l] = xn * b1[l] - y * a1[l] + st2[l];
+                st2[l] = -y * a2[l];
+                accn[l] += y;
+            }
+        }
+
+        for (unsigned int l = 0; l < LaneWidth; ++l)
+        {
+            s1[l] = st1[l];
+            s2[l] = st2[l];
+        }
+    }
+
+    // Number of sections rounded up to full groups of LaneWidth
+    unsigned int getNumPaddedSections() const noexcept { return ((numSections + LaneWidth - 1) / LaneWidth) * LaneWidth; }
+
+    unsigned int allocatedChannels { 0 };
+    unsigned int allocatedSections { 0 };
+    unsigned int numSections { 0 };
+
+    // Gain of the direct path d0
+    float directGain { 0.f };
+
+    // Coeffs of all sections, one vector per coefficient, padded with silent sections
+    // [s0_beta0, s1_beta0, ...], [s0_beta1, ...], [s0_a1, ...], [s0_a2, ...]
+    std::array<std::vector<float>, ParallelCoeffsPerSection> coeffs;
+
+    // Transposed Direct Form II states of all channels and sections
+    // [ch0_s0_s1, ch0_s1_s1, ... , ch1_s0_s1, ...], [ch0_s0_s2, ...]
+    std::array<std::vector<float>, 2> states;
+};
+
+}
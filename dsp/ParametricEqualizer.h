@@ -1,11 +1,19 @@
 #pragma once
 
 #include "Biquad.h"
+#include "FixedBiquad.h"
+#include "FrequencyResponse.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
 
 namespace mrta
 {
 
-class ParametricEqualizer
+// Filter types and coefficient design shared by all ParametricEqualizer realisations
+class ParametricEqualizerBase
 {
 public:
     enum FilterType : unsigned int
@@ -18,25 +26,51 @@ public:
         HighShelf
     };
 
+protected:
+    static const unsigned int CoeffsPerBand = 5;
+
+    // Structure to hold band filter information
+    struct Band
+    {
+        FilterType type { Flat };
+        float freq { 1000.f };
+        float reso { 0.7071f };
+        float gain { 0.f };
+    };
+
+    // Helper function to calculate coefficients
+    // Designed in double, so filters with double coefficients keep the full precision
+    static std::array<double, CoeffsPerBand> calculateCoeffs(const Band& band, double sampleRate);
+};
+
+// Filter is the biquad cascade realising the bands, mrta::Biquad when the number
+// of bands is only known at runtime or a mrta::FixedBiquad when it is known at
+// compile time (see FixedParametricEqualizer)
+template<typename Filter>
+class BasicParametricEqualizer : public ParametricEqualizerBase
+{
+public:
+    static_assert(Filter::CoeffsPerSection == CoeffsPerBand, "Filter sections must be biquads.");
+
     // Main ctor
     // Requires number of bands and channels to be allocated
     // The number of bands cannot be modified later but channels can be reallocated
     // All bands filters will be initialised to Flat
-    ParametricEqualizer(unsigned int numOfBands, unsigned int maxNumChannels = 2);
+    BasicParametricEqualizer(unsigned int numOfBands, unsigned int maxNumChannels = 2);
 
     // Dtor
-    ~ParametricEqualizer();
+    ~BasicParametricEqualizer();
 
     // No default ctor
-    ParametricEqualizer() = delete;
+    BasicParametricEqualizer() = delete;
 
     // No copy sematics
-    ParametricEqualizer(const ParametricEqualizer&) = delete;
-    const ParametricEqualizer& operator=(const ParametricEqualizer&) = delete;
+    BasicParametricEqualizer(const BasicParametricEqualizer&) = delete;
+    const BasicParametricEqualizer& operator=(const BasicParametricEqualizer&) = delete;
 
     // No move semantics
-    ParametricEqualizer(ParametricEqualizer&&) = delete;
-    const ParametricEqualizer& operator=(ParametricEqualizer&&) = delete;
+    BasicParametricEqualizer(BasicParametricEqualizer&&) = delete;
+    const BasicParametricEqualizer& operator=(BasicParametricEqualizer&&) = delete;
 
     // Clear states
     void clear();
@@ -44,9 +78,10 @@ public:
     // Clear states, recalculate coeffs to new sample rate and reallocate channels
     void prepare(double sampleRate, unsigned int maxNumChannels);
 
-    // Process audio buffers
+    // Process float or double audio buffers
     // This method can be called with a lower number of channels than allocated
-    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+    template<typename Sample>
+    void process(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples);
 
     // Set filter type of a band
     void setBandType(unsigned int band, FilterType type);
@@ -60,27 +95,138 @@ public:
     // Set filter gain of a band in dB
     void setBandGain(unsigned int band, float gain);
 
+    // Evaluate the response of all bands on the frequency grid of response
+    // The grid must be set for the current sample rate, and only the bands
+    // changed since the last call on the same response are evaluated again
+    void updateFrequencyResponse(FrequencyResponse& response) const;
+
 private:
+    using CoeffType = typename Filter::CoeffType;
+
+    // Coefficients of a band in the coefficient type of the filter
+    std::array<CoeffType, CoeffsPerBand> getBandCoeffs(const Band& band) const
+    {
+        const std::array<double, CoeffsPerBand> coeffs { calculateCoeffs(band, sampleRate) };
+
+        std::array<CoeffType, CoeffsPerBand> bandCoeffs;
+        for (unsigned int k = 0; k < CoeffsPerBand; ++k)
+            bandCoeffs[k] = static_cast<CoeffType>(coeffs[k]);
+
+        return bandCoeffs;
+    }
+
     // Biquad structure for filter realization
-    mrta::Biquad biquad;
+    Filter biquad;
 
     // Current sample rate of coefficients
     double sampleRate { 48000.0 };
 
-    // Structure to hold band filter information
-    struct Band
-    {
-        FilterType type { Flat };
-        float freq { 1000.f };
-        float reso { 0.7071f };
-        float gain { 0.f };
-    };
-
     // All bands information
     std::vector<Band> bands;
-
-    // Helper function to calculate coefficients
-    std::array<float, mrta::Biquad::CoeffsPerSection> calculateCoeffs(const Band & band);
 };
 
+// Equalizer with the number of bands set at runtime
+using ParametricEqualizer = BasicParametricEqualizer<mrta::Biquad>;
+
+// Equalizer with the number of bands and channels set at compile time
+// Real is the type of the filter coefficients and states
+template<unsigned int NumBands, unsigned int MaxChannels, typename Real = float>
+using FixedParametricEqualizer = BasicParametricEqualizer<mrta::FixedBiquad<NumBands, MaxChannels, BiquadTopology::DirectFormI, Real>>;
+
+template<typename Filter>
+BasicParametricEqualizer<Filter>::BasicParametricEqualizer(unsigned int numOfBands, unsigned int maxNumChannels) :
+    biquad(numOfBands, maxNumChannels),
+    bands(numOfBands)
+{
+    unsigned int b { 0 };
+    for (const auto& band : bands)
+        biquad.setSectionCoeffs(getBandCoeffs(band), b++);
+}
+
+template<typename Filter>
+BasicParametricEqualizer<Filter>::~BasicParametricEqualizer()
+{
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::clear()
+{
+    biquad.clear();
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::prepare(double newSampleRate, unsigned int maxNumChannels)
+{
+    biquad.reallocateChannels(maxNumChannels);
+
+    sampleRate = std::fmax(newSampleRate, 1.f);
+
+    unsigned int b { 0 };
+    for (const auto& band : bands)
+        biquad.setSectionCoeffs(getBandCoeffs(band), b++);
+}
+
+template<typename Filter>
+template<typename Sample>
+void BasicParametricEqualizer<Filter>::process(Sample* const* output, const Sample* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    biquad.process(output, input, numChannels, numSamples);
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::setBandType(unsigned int band, FilterType type)
+{
+    if (band < bands.size() && band < biquad.getAllocatedSections())
+    {
+        bands[band].type = type;
+        biquad.setSectionCoeffs(getBandCoeffs(bands[band]), band);
+    }
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::setBandFrequency(unsigned int band, float frequency)
+{
+    if (band < bands.size() && band < biquad.getAllocatedSections())
+    {
+        bands[band].freq = std::fmax(frequency, 2.f);
+        biquad.setSectionCoeffs(getBandCoeffs(bands[band]), band);
+    }
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::setBandResonance(unsigned int band, float resonance)
+{
+    if (band < bands.size() && band < biquad.getAllocatedSections())
+    {
+        bands[band].reso = std::fmax(resonance, 0.1f);
+        biquad.setSectionCoeffs(getBandCoeffs(bands[band]), band);
+    }
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::setBandGain(unsigned int band, float gain)
+{
+    if (band < bands.size() && band < biquad.getAllocatedSections())
+    {
+        bands[band].gain = gain;
+        biquad.setSectionCoeffs(getBandCoeffs(bands[band]), band);
+    }
+}
+
+template<typename Filter>
+void BasicParametricEqualizer<Filter>::updateFrequencyResponse(FrequencyResponse& response) const
+{
+    const unsigned int numBands { std::min(static_cast<unsigned int>(bands.size()), response.getNumSections()) };
+    for (unsigned int b = 0; b < numBands; ++b)
+    {
+        // Evaluate the coefficients as rounded for the filter
+        const std::array<CoeffType, CoeffsPerBand> c { getBandCoeffs(bands[b]) };
+        response.setSectionCoeffs({ c[0], c[1], c[2], c[3], c[4] }, b);
+    }
+
+    response.update();
+}
+
+extern template class BasicParametricEqualizer<mrta::Biquad>;
+
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 
 namespace mrta
@@ -32,10 +33,11 @@ public:
     const Ramp& operator=(Ramp&&) = delete;
 
     // Update sample rate of the ramp time, optionally allowing to
-    // skip to ramp value
+    // skip to ramp value, pending events are dropped
     void prepare(double newSampleRate, bool skipRamp = false, F skipRampToValue = static_cast<F>(0))
     {
         sampleRate = newSampleRate;
+        clearEvents();
         if (skipRamp)
             setTarget(skipRampToValue, true);
         else
@@ -46,106 +48,112 @@ public:
     // optionally allowing to skip the ramp
     void setTarget(F newTargetValue, bool skipRamp = false)
     {
-        if (std::abs(newTargetValue - currentValue) > minDelta)
-        {
-            targetValue = newTargetValue;
-            rampStep = (targetValue - currentValue) / static_cast<F>(sampleRate * rampTime);
-        }
+        startRamp(newTargetValue, rampTime);
 
         if (skipRamp)
+        {
             currentValue = targetValue = newTargetValue;
+            rampSamples = 0;
+        }
+    }
+
+    // Queue a ramp to a new target over newRampTimeSec, starting sampleOffset samples after the start
+    // of the next block, a ramp time of zero jumps to the target
+    // Events at the same offset start in the order they were added, so the last one wins
+    // Returns false if the queue is full, it never allocates
+    bool addEvent(unsigned int sampleOffset, F newTargetValue, F newRampTimeSec)
+    {
+        if (numEvents == MaxEvents)
+            return false;
+
+        unsigned int e { numEvents };
+        for (; e > 0 && events[e - 1].sampleOffset > sampleOffset; --e)
+            events[e] = events[e - 1];
+
+        events[e] = { sampleOffset, newTargetValue, newRampTimeSec };
+        ++numEvents;
+        return true;
+    }
+
+    // Drop the pending events
+    void clearEvents()
+    {
+        numEvents = 0;
+    }
+
+    // Write the ramp values of the next numSamples samples to a buffer,
+    // to reuse them across channels or combine them with other control signals
+    void render(F* output, unsigned int numSamples)
+    {
+        processSegments(numSamples, [&](unsigned int begin, unsigned int end)
+        {
+            const unsigned int numRamp { begin + std::min(rampSamples, end - begin) };
+            const F start { currentValue };
+            const F step { rampStep };
+            for (unsigned int n = begin; n < numRamp; ++n)
+                output[n] = start + static_cast<F>(n - begin + 1) * step;
+
+            advance(numRamp - begin, end - begin);
+
+            std::fill(output + numRamp, output + end, currentValue);
+        });
     }
 
     // Apply summing ramp to a single sample in-place
     void applySum(F* buffers, unsigned int numChannels)
     {
-        const F targetDelta { std::fabs(targetValue - currentValue) };
-        if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-            currentValue += rampStep;
-        else
-            currentValue = targetValue;
-
+        const F value { nextValue() };
         for (unsigned int ch = 0; ch < numChannels; ++ch)
-            buffers[ch] += currentValue;
+            buffers[ch] += value;
     }
 
     // Apply summing ramp to an audio buffer in-place
     void applySum(F* const* buffers, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        processSegments(numSamples, [&](unsigned int begin, unsigned int end)
         {
-            const F targetDelta { std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
-            for (unsigned int ch = 0; ch < numChannels; ++ch)
-                buffers[ch][n] += currentValue;
-        }
+            applySumSegment(buffers, numChannels, begin, end);
+        });
     }
 
     // Apply summing ramp to an audio buffer out-of-place
     void applySum(F* const* output, const F* const* input, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        processSegments(numSamples, [&](unsigned int begin, unsigned int end)
         {
-            const F targetDelta { std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
-            for (unsigned int ch = 0; ch < numChannels; ++ch)
-                output[ch][n] = currentValue + input[ch][n];
-        }
+            applySumSegment(output, input, numChannels, begin, end);
+        });
     }
 
     // Apply gain ramp to an audio buffer in-place for single sample
     void applyGain(F* buffers, unsigned int numChannels)
     {
-        const F targetDelta { std::fabs(targetValue - currentValue) };
-        if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-            currentValue += rampStep;
-        else
-            currentValue = targetValue;
-
+        const F value { nextValue() };
         for (unsigned int ch = 0; ch < numChannels; ++ch)
-            buffers[ch] *= currentValue;
+            buffers[ch] *= value;
     }
 
     // Apply gain ramp to an audio buffer in-place
     void applyGain(F* const* buffers, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        processSegments(numSamples, [&](unsigned int begin, unsigned int end)
         {
-            const F targetDelta { std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
-            for (unsigned int ch = 0; ch < numChannels; ++ch)
-                buffers[ch][n] *= currentValue;
-        }
+            applyGainSegment(buffers, numChannels, begin, end);
+        });
     }
 
     // Apply gain ramp to an audio buffer out-of-place
     void applyGain(F* const* output, const F* const* input, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        processSegments(numSamples, [&](unsigned int begin, unsigned int end)
         {
-            const F targetDelta{ std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
-            for (unsigned int ch = 0; ch < numChannels; ++ch)
-                output[ch][n] = currentValue * input[ch][n];
-        }
+            applyGainSegment(output, input, numChannels, begin, end);
+        });
     }
 
+    // Maximum number of pending events
+    static constexpr unsigned int MaxEvents { 32 };
+
     // Minimum ramp time in secondes
     static constexpr F minRampTime { static_cast<F>(1e-3) }; // 1ms
 
@@ -153,11 +161,212 @@ public:
     static constexpr F minDelta { static_cast<F>(1e-9) };
 
 private:
+    struct Event
+    {
+        unsigned int sampleOffset;
+        F target;
+        F rampTimeSec;
+    };
+
+    // Ramp from the current value to a new target over newRampTimeSec
+    void startRamp(F newTargetValue, F newRampTimeSec)
+    {
+        if (std::abs(newTargetValue - currentValue) > minDelta)
+        {
+            targetValue = newTargetValue;
+            rampStep = (targetValue - currentValue) / static_cast<F>(sampleRate * newRampTimeSec);
+
+            // The value steps while it is further than two steps from the target, then jumps to it
+            const double steps { std::ceil(std::abs(static_cast<double>(targetValue - currentValue) / static_cast<double>(rampStep))) - 2.0 };
+            rampSamples = (std::abs(rampStep) > minDelta && steps > 0.0) ? static_cast<unsigned int>(steps) : 0;
+        }
+    }
+
+    // Split a block at the events due in it, process(begin, end) runs every segment with its ramp,
+    // then the pending events move on to the next block
+    template<typename Process>
+    void processSegments(unsigned int numSamples, Process&& process)
+    {
+        if (numEvents == 0)
+        {
+            process(0u, numSamples);
+            return;
+        }
+
+        unsigned int e { 0 };
+        unsigned int begin { 0 };
+        while (begin < numSamples)
+        {
+            for (; e < numEvents && events[e].sampleOffset <= begin; ++e)
+            {
+                if (events[e].rampTimeSec > static_cast<F>(0))
+                    startRamp(events[e].target, std::fmax(events[e].rampTimeSec, minRampTime));
+                else
+                    setTarget(events[e].target, true);
+            }
+
+            const unsigned int end { e < numEvents ? std::min(events[e].sampleOffset, numSamples) : numSamples };
+            process(begin, end);
+            begin = end;
+        }
+
+        for (unsigned int i = e; i < numEvents; ++i)
+        {
+            events[i - e] = events[i];
+            events[i - e].sampleOffset -= numSamples;
+        }
+
+        numEvents -= e;
+    }
+
+    void applySumSegment(F* const* buffers, unsigned int numChannels, unsigned int begin, unsigned int end)
+    {
+        const unsigned int numRamp { begin + std::min(rampSamples, end - begin) };
+        const F start { currentValue };
+        const F step { rampStep };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int n = begin; n < numRamp; ++n)
+                buffers[ch][n] += start + static_cast<F>(n - begin + 1) * step;
+
+        advance(numRamp - begin, end - begin);
+
+        // A zero offset leaves the settled samples as they are
+        const F value { currentValue };
+        if (numRamp == end || value == static_cast<F>(0))
+            return;
+
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int n = numRamp; n < end; ++n)
+                buffers[ch][n] += value;
+    }
+
+    void applySumSegment(F* const* output, const F* const* input, unsigned int numChannels, unsigned int begin, unsigned int end)
+    {
+        const unsigned int numRamp { begin + std::min(rampSamples, end - begin) };
+        const F start { currentValue };
+        const F step { rampStep };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int n = begin; n < numRamp; ++n)
+                output[ch][n] = start + static_cast<F>(n - begin + 1) * step + input[ch][n];
+
+        advance(numRamp - begin, end - begin);
+
+        // A zero offset copies the settled samples
+        const F value { currentValue };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            if (value == static_cast<F>(0))
+            {
+                if (output[ch] != input[ch])
+                    std::copy(input[ch] + numRamp, input[ch] + end, output[ch] + numRamp);
+            }
+            else
+            {
+                for (unsigned int n = numRamp; n < end; ++n)
+                    output[ch][n] = value + input[ch][n];
+            }
+        }
+    }
+
+    void applyGainSegment(F* const* buffers, unsigned int numChannels, unsigned int begin, unsigned int end)
+    {
+        const unsigned int numRamp { begin + std::min(rampSamples, end - begin) };
+        const F start { currentValue };
+        const F step { rampStep };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int n = begin; n < numRamp; ++n)
+                buffers[ch][n] *= start + static_cast<F>(n - begin + 1) * step;
+
+        advance(numRamp - begin, end - begin);
+
+        // A unity gain leaves the settled samples as they are
+        const F value { currentValue };
+        if (numRamp == end || value == static_cast<F>(1))
+            return;
+
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int n = numRamp; n < end; ++n)
+                buffers[ch][n] *= value;
+    }
+
+    void applyGainSegment(F* const* output, const F* const* input, unsigned int numChannels, unsigned int begin, unsigned int end)
+    {
+        const unsigned int numRamp { begin + std::min(rampSamples, end - begin) };
+        const F start { currentValue };
+        const F step { rampStep };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            for (unsigned int n = begin; n < numRamp; ++n)
+                output[ch][n] = (start + static_cast<F>(n - begin + 1) * step) * input[ch][n];
+
+        advance(numRamp - begin, end - begin);
+
+        // A unity gain copies the settled samples
+        const F value { currentValue };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            if (value == static_cast<F>(1))
+            {
+                if (output[ch] != input[ch])
+                    std::copy(input[ch] + numRamp, input[ch] + end, output[ch] + numRamp);
+            }
+            else
+            {
+                for (unsigned int n = numRamp; n < end; ++n)
+                    output[ch][n] = value * input[ch][n];
+            }
+        }
+    }
+
+    // Value of the next sample, one step along the ramp, or the target once it is reached
+    F nextValue()
+    {
+        if (numEvents > 0)
+        {
+            // Start the events due at this sample and move the others on by one sample
+            F value { targetValue };
+            processSegments(1u, [&](unsigned int, unsigned int) { value = stepValue(); });
+            return value;
+        }
+
+        return stepValue();
+    }
+
+    F stepValue()
+    {
+        if (rampSamples > 0)
+        {
+            currentValue += rampStep;
+            --rampSamples;
+        }
+        else
+        {
+            currentValue = targetValue;
+        }
+
+        return currentValue;
+    }
+
+    // Move the ramp past a segment, whose first numRamp samples were ramping
+    void advance(unsigned int numRamp, unsigned int numSamples)
+    {
+        currentValue += static_cast<F>(numRamp) * rampStep;
+        rampSamples -= numRamp;
+        if (numRamp < numSamples)
+            currentValue = targetValue;
+    }
+
     double sampleRate { 48000.0 };
     F rampTime;
     F rampStep { static_cast<F>(0) };
     F targetValue { static_cast<F>(0) };
     F currentValue { static_cast<F>(0) };
+
+    // Samples left before the value reaches the target
+    unsigned int rampSamples { 0 };
+
+    // Pending events, sorted by offset
+    Event events[MaxEvents] { };
+    unsigned int numEvents { 0 };
 };
 
 }
@@ -10,7 +10,8 @@ static const std::vector<mrta::ParameterInfo> Parameters
     { Param::ID::Depth,    Param::Name::Depth,    Param::Units::Ms,  2.f,  Param::Ranges::DepthMin,    Param::Ranges::DepthMax,    Param::Ranges::DepthInc,    Param::Ranges::DepthSkw },
     { Param::ID::Feedback, Param::Name::Feedback, Param::Units::Pct, 0.f,  Param::Ranges::FeedbackMin, Param::Ranges::FeedbackMax, Param::Ranges::FeedbackInc, Param::Ranges::FeedbackSkw },
     { Param::ID::Rate,     Param::Name::Rate,     Param::Units::Hz,  0.5f, Param::Ranges::RateMin,     Param::Ranges::RateMax,     Param::Ranges::RateInc,     Param::Ranges::RateSkw },
-    { Param::ID::ModType,  Param::Name::ModType,  Param::Ranges::ModLabels, 0 }
+    { Param::ID::ModType,  Param::Name::ModType,  Param::Ranges::ModLabels, 0 },
+    { Param::ID::Voices,   Param::Name::Voices,   Param::Ranges::VoiceLabels, 0 }
 };
 
 FlangerAudioProcessor::FlangerAudioProcessor() :
@@ -54,6 +55,12 @@ FlangerAudioProcessor::FlangerAudioProcessor() :
         mrta::Flanger::ModulationType modType = static_cast<mrta::Flanger::ModulationType>(std::round(newValue));
         flanger.setModulationType(std::min(std::max(modType, mrta::Flanger::Sin), mrta::Flanger::Saw));
     });
+
+    parameterManager.registerParameterCallback(Param::ID::Voices,
+    [this](float newValue, bool /*force*/)
+    {
+        flanger.setNumVoices(static_cast<unsigned int>(std::round(newValue)) + 1);
+    });
 }
 
 FlangerAudioProcessor::~FlangerAudioProcessor()
@@ -13,6 +13,7 @@ namespace Param
         static const juce::String Feedback { "feedback" };
         static const juce::String Rate { "rate" };
         static const juce::String ModType { "mod_type" };
+        static const juce::String Voices { "voices" };
     }
 
     namespace Name
@@ -23,6 +24,7 @@ namespace Param
         static const juce::String Feedback { "Feedback" };
         static const juce::String Rate { "Rate" };
         static const juce::String ModType { "Mod. Type" };
+        static const juce::String Voices { "Voices" };
     }
 
     namespace Ranges
@@ -49,6 +51,8 @@ namespace Param
 
         static const juce::StringArray ModLabels { "Sine", "Triangle", "Sawtooth" };
 
+        static const juce::StringArray VoiceLabels { "1", "2", "3", "4" };
+
         static const juce::String EnabledOff { "Off" };
         static const juce::String EnabledOn { "On" };
     }
@@ -124,6 +124,14 @@ void ParametricEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     eq.process(buffer.getArrayOfWritePointers(), buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
 }
 
+void ParametricEQAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& /*midiMessages*/)
+{
+    juce::ScopedNoDenormals noDenormals;
+    parameterManager.updateParameters();
+
+    eq.process(buffer.getArrayOfWritePointers(), buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+}
+
 void ParametricEQAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     parameterManager.getStateInformation(destData);
@@ -139,6 +147,7 @@ const juce::String ParametricEQAudioProcessor::getName() const { return JucePlug
 bool ParametricEQAudioProcessor::acceptsMidi() const { return false; }
 bool ParametricEQAudioProcessor::producesMidi() const { return false; }
 bool ParametricEQAudioProcessor::isMidiEffect() const { return false; }
+bool ParametricEQAudioProcessor::supportsDoublePrecisionProcessing() const { return true; }
 double ParametricEQAudioProcessor::getTailLengthSeconds() const { return 0.0; }
 int ParametricEQAudioProcessor::getNumPrograms() { return 1; }
 int ParametricEQAudioProcessor::getCurrentProgram() { return 0; }
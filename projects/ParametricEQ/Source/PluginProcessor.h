@@ -88,6 +88,8 @@ public:
     void releaseResources() override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
@@ -111,7 +113,8 @@ public:
 
 private:
     mrta::ParameterManager parameterManager;
-    mrta::ParametricEqualizer eq;
+    // Double coeffs and states, low frequency shelves stay accurate at high sample rates
+    mrta::FixedParametricEqualizer<3, 2, double> eq;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParametricEQAudioProcessor)
 };
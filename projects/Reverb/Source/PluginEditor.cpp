@@ -0,0 +1,27 @@
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+ReverbAudioProcessorEditor::ReverbAudioProcessorEditor(ReverbAudioProcessor& p) :
+    AudioProcessorEditor(&p), audioProcessor(p),
+    genericParameterEditor(audioProcessor.getParameterManager())
+{
+    unsigned int numParams { static_cast<unsigned int>(audioProcessor.getParameterManager().getParameters().size()) };
+    unsigned int paramHeight { static_cast<unsigned int>(genericParameterEditor.parameterWidgetHeight) };
+
+    addAndMakeVisible(genericParameterEditor);
+    setSize(300, numParams * paramHeight);
+}
+
+ReverbAudioProcessorEditor::~ReverbAudioProcessorEditor()
+{
+}
+
+void ReverbAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+}
+
+void ReverbAudioProcessorEditor::resized()
+{
+    genericParameterEditor.setBounds(getLocalBounds());
+}
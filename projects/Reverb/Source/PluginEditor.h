@@ -0,0 +1,20 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+class ReverbAudioProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    ReverbAudioProcessorEditor (ReverbAudioProcessor&);
+    ~ReverbAudioProcessorEditor() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    ReverbAudioProcessor& audioProcessor;
+    mrta::GenericParameterEditor genericParameterEditor;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbAudioProcessorEditor)
+};
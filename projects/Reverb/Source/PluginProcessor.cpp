@@ -0,0 +1,152 @@
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+#include <algorithm>
+
+static const std::vector<mrta::ParameterInfo> Parameters
+{
+    { Param::ID::Enabled,     Param::Name::Enabled,     Param::Ranges::EnabledOff, Param::Ranges::EnabledOn, true },
+    { Param::ID::Size,        Param::Name::Size,        Param::Units::Ms,  40.f,    Param::Ranges::SizeMin,        Param::Ranges::SizeMax,        Param::Ranges::SizeInc,        Param::Ranges::SizeSkw },
+    { Param::ID::Decay,       Param::Name::Decay,       Param::Units::S,   2.f,     Param::Ranges::DecayMin,       Param::Ranges::DecayMax,       Param::Ranges::DecayInc,       Param::Ranges::DecaySkw },
+    { Param::ID::Damping,     Param::Name::Damping,     Param::Units::Pct, 50.f,    Param::Ranges::DampingMin,     Param::Ranges::DampingMax,     Param::Ranges::DampingInc,     Param::Ranges::DampingSkw },
+    { Param::ID::DampingFreq, Param::Name::DampingFreq, Param::Units::Hz,  4000.f,  Param::Ranges::DampingFreqMin, Param::Ranges::DampingFreqMax, Param::Ranges::DampingFreqInc, Param::Ranges::DampingFreqSkw },
+    { Param::ID::Mix,         Param::Name::Mix,         Param::Units::Pct, 30.f,    Param::Ranges::MixMin,         Param::Ranges::MixMax,         Param::Ranges::MixInc,         Param::Ranges::MixSkw },
+    { Param::ID::Lines,       Param::Name::Lines,       Param::Ranges::LinesLabels, 1 },
+    { Param::ID::Matrix,      Param::Name::Matrix,      Param::Ranges::MatrixLabels, 0 }
+};
+
+ReverbAudioProcessor::ReverbAudioProcessor() :
+    parameterManager(*this, ProjectInfo::projectName, Parameters),
+    reverb(Param::Ranges::SizeMax, mrta::FeedbackDelayNetwork::MaxLines),
+    mixRamp(0.05f),
+    enableRamp(0.05f)
+{
+    parameterManager.registerParameterCallback(Param::ID::Enabled,
+    [this](float newValue, bool force)
+    {
+        enableRamp.setTarget(std::fmin(std::fmax(newValue, 0.f), 1.f), force);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Size,
+    [this](float newValue, bool /*force*/)
+    {
+        reverb.setSize(newValue);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Decay,
+    [this](float newValue, bool /*force*/)
+    {
+        reverb.setDecayTime(newValue);
+    });
+
+    // Damping is the loss of high frequency decay time, in percent of the decay time
+    parameterManager.registerParameterCallback(Param::ID::Damping,
+    [this](float newValue, bool /*force*/)
+    {
+        reverb.setDamping(1.f - newValue * 0.01f);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::DampingFreq,
+    [this](float newValue, bool /*force*/)
+    {
+        reverb.setDampingFrequency(newValue);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Mix,
+    [this](float newValue, bool force)
+    {
+        mixRamp.setTarget(std::fmin(std::fmax(newValue * 0.01f, 0.f), 1.f), force);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Lines,
+    [this](float newValue, bool /*force*/)
+    {
+        reverb.setNumLines(std::round(newValue) > 0.f ? 16 : 8);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Matrix,
+    [this](float newValue, bool /*force*/)
+    {
+        mrta::FeedbackDelayNetwork::FeedbackMatrix matrix = static_cast<mrta::FeedbackDelayNetwork::FeedbackMatrix>(std::round(newValue));
+        reverb.setFeedbackMatrix(std::min(std::max(matrix, mrta::FeedbackDelayNetwork::Hadamard), mrta::FeedbackDelayNetwork::Householder));
+    });
+}
+
+ReverbAudioProcessor::~ReverbAudioProcessor()
+{
+}
+
+void ReverbAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
+{
+    const unsigned int numChannels { static_cast<unsigned int>(std::max(getMainBusNumInputChannels(), getMainBusNumOutputChannels())) };
+
+    reverb.prepare(newSampleRate, Param::Ranges::SizeMax);
+    mixRamp.prepare(newSampleRate);
+    enableRamp.prepare(newSampleRate);
+
+    parameterManager.updateParameters(true);
+
+    fxBuffer.setSize(static_cast<int>(numChannels), samplesPerBlock);
+    fxBuffer.clear();
+}
+
+void ReverbAudioProcessor::releaseResources()
+{
+    reverb.clear();
+}
+
+void ReverbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/)
+{
+    juce::ScopedNoDenormals noDenormals;
+    parameterManager.updateParameters();
+
+    const unsigned int numChannels { static_cast<unsigned int>(buffer.getNumChannels()) };
+    const unsigned int numSamples { static_cast<unsigned int>(buffer.getNumSamples()) };
+
+    for (int ch = 0; ch < static_cast<int>(numChannels); ++ch)
+        fxBuffer.copyFrom(ch, 0, buffer, ch, 0, static_cast<int>(numSamples));
+
+    reverb.process(fxBuffer.getArrayOfWritePointers(), fxBuffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    // The mix crossfades from the dry to the reverb signal, as the difference of both is added to the dry signal
+    for (int ch = 0; ch < static_cast<int>(numChannels); ++ch)
+        fxBuffer.addFrom(ch, 0, buffer, ch, 0, static_cast<int>(numSamples), -1.f);
+
+    mixRamp.applyGain(fxBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+    enableRamp.applyGain(fxBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+    for (int ch = 0; ch < static_cast<int>(numChannels); ++ch)
+        buffer.addFrom(ch, 0, fxBuffer, ch, 0, static_cast<int>(numSamples));
+}
+
+void ReverbAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    parameterManager.getStateInformation(destData);
+}
+
+void ReverbAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    parameterManager.setStateInformation(data, sizeInBytes);
+}
+
+//==============================================================================
+bool ReverbAudioProcessor::hasEditor() const { return true; }
+juce::AudioProcessorEditor* ReverbAudioProcessor::createEditor() { return new ReverbAudioProcessorEditor(*this); }
+const juce::String ReverbAudioProcessor::getName() const { return JucePlugin_Name; }
+bool ReverbAudioProcessor::acceptsMidi() const { return false; }
+bool ReverbAudioProcessor::producesMidi() const { return false; }
+bool ReverbAudioProcessor::isMidiEffect() const { return false; }
+double ReverbAudioProcessor::getTailLengthSeconds() const { return static_cast<double>(Param::Ranges::DecayMax); }
+int ReverbAudioProcessor::getNumPrograms() { return 1; }
+int ReverbAudioProcessor::getCurrentProgram() { return 0; }
+void ReverbAudioProcessor::setCurrentProgram(int) { }
+const juce::String ReverbAudioProcessor::getProgramName (int) { return {}; }
+void ReverbAudioProcessor::changeProgramName (int, const juce::String&) { }
+//==============================================================================
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ReverbAudioProcessor();
+}
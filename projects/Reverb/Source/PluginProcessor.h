@@ -0,0 +1,115 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "FeedbackDelayNetwork.h"
+#include "Ramp.h"
+
+namespace Param
+{
+    namespace ID
+    {
+        static const juce::String Enabled { "enabled" };
+        static const juce::String Size { "size" };
+        static const juce::String Decay { "decay" };
+        static const juce::String Damping { "damping" };
+        static const juce::String DampingFreq { "damping_freq" };
+        static const juce::String Mix { "mix" };
+        static const juce::String Lines { "lines" };
+        static const juce::String Matrix { "matrix" };
+    }
+
+    namespace Name
+    {
+        static const juce::String Enabled { "Enabled" };
+        static const juce::String Size { "Size" };
+        static const juce::String Decay { "Decay" };
+        static const juce::String Damping { "Damping" };
+        static const juce::String DampingFreq { "Damping Freq." };
+        static const juce::String Mix { "Mix" };
+        static const juce::String Lines { "Lines" };
+        static const juce::String Matrix { "Matrix" };
+    }
+
+    namespace Ranges
+    {
+        static constexpr float SizeMin { 10.f };
+        static constexpr float SizeMax { 100.f };
+        static constexpr float SizeInc { 0.1f };
+        static constexpr float SizeSkw { 0.5f };
+
+        static constexpr float DecayMin { 0.1f };
+        static constexpr float DecayMax { 20.f };
+        static constexpr float DecayInc { 0.01f };
+        static constexpr float DecaySkw { 0.3f };
+
+        static constexpr float DampingMin { 0.f };
+        static constexpr float DampingMax { 95.f };
+        static constexpr float DampingInc { 0.1f };
+        static constexpr float DampingSkw { 1.f };
+
+        static constexpr float DampingFreqMin { 500.f };
+        static constexpr float DampingFreqMax { 16000.f };
+        static constexpr float DampingFreqInc { 1.f };
+        static constexpr float DampingFreqSkw { 0.3f };
+
+        static constexpr float MixMin { 0.f };
+        static constexpr float MixMax { 100.f };
+        static constexpr float MixInc { 0.1f };
+        static constexpr float MixSkw { 1.f };
+
+        static const juce::StringArray LinesLabels { "8", "16" };
+        static const juce::StringArray MatrixLabels { "Hadamard", "Householder" };
+
+        static const juce::String EnabledOff { "Off" };
+        static const juce::String EnabledOn { "On" };
+    }
+
+    namespace Units
+    {
+        static const juce::String Ms { "ms" };
+        static const juce::String S { "s" };
+        static const juce::String Hz { "Hz" };
+        static const juce::String Pct { "%" };
+    }
+}
+
+class ReverbAudioProcessor : public juce::AudioProcessor
+{
+public:
+    ReverbAudioProcessor();
+    ~ReverbAudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void releaseResources() override;
+
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    mrta::ParameterManager& getParameterManager() { return parameterManager; }
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+    const juce::String getName() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+    //==============================================================================
+
+private:
+    mrta::ParameterManager parameterManager;
+    mrta::FeedbackDelayNetwork reverb;
+    mrta::Ramp<float> mixRamp;
+    mrta::Ramp<float> enableRamp;
+
+    juce::AudioBuffer<float> fxBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReverbAudioProcessor)
+};
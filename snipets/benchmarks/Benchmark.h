@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Windows does not have Pi constants
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+// Helpers shared by the benchmarks
+// Build the benchmarks with optimisations and for the host CPU, e.g. -O3 -march=native,
+// the lane width of the vectorised kernels follows the instruction set enabled at compile time
+namespace bench
+{
+
+// Multichannel audio buffer, filled with white noise in [-0.5, 0.5]
+template<typename Sample = float>
+class Buffer
+{
+public:
+    Buffer(unsigned int numChannels, unsigned int numSamples, unsigned int seed = 1) :
+        data(numChannels, std::vector<Sample>(numSamples))
+    {
+        std::mt19937 rng { seed };
+        std::uniform_real_distribution<Sample> noise { static_cast<Sample>(-0.5), static_cast<Sample>(0.5) };
+        for (auto& channel : data)
+        {
+            for (auto& x : channel)
+                x = noise(rng);
+
+            writePointers.push_back(channel.data());
+            readPointers.push_back(channel.data());
+        }
+    }
+
+    Sample* const* write() { return writePointers.data(); }
+    const Sample* const* read() const { return readPointers.data(); }
+
+    std::vector<Sample>& operator[](unsigned int channel) { return data[channel]; }
+    const std::vector<Sample>& operator[](unsigned int channel) const { return data[channel]; }
+
+private:
+    std::vector<std::vector<Sample>> data;
+    std::vector<Sample*> writePointers;
+    std::vector<const Sample*> readPointers;
+};
+
+// Time of a call to process in nanoseconds per processed sample, where a call processes numSamples samples
+// The calls are repeated for at least MinRunTime per run, the fastest of NumRuns runs is kept
+template<typename Process>
+double nsPerSample(Process&& process, double numSamples)
+{
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::milliseconds MinRunTime { 20 };
+    static constexpr unsigned int NumRuns { 5 };
+
+    // Warm up the caches, then find the number of calls lasting at least MinRunTime
+    process();
+
+    unsigned int numCalls { 1 };
+    for (;;)
+    {
+        const auto start { Clock::now() };
+        for (unsigned int k = 0; k < numCalls; ++k)
+            process();
+
+        if (Clock::now() - start >= MinRunTime)
+            break;
+
+        numCalls *= 2;
+    }
+
+    double best { std::numeric_limits<double>::max() };
+    for (unsigned int r = 0; r < NumRuns; ++r)
+    {
+        const auto start { Clock::now() };
+        for (unsigned int k = 0; k < numCalls; ++k)
+            process();
+
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+
+    return best / (static_cast<double>(numCalls) * numSamples);
+}
+
+// Peak filter coefficients [b0, b1, b2, a1, a2], same design as mrta::ParametricEqualizer
+inline std::array<double, 5> peakCoeffs(double freq, double q, double gainDb, double sampleRate)
+{
+    const double A { std::sqrt(std::pow(10.0, gainDb * 0.05)) };
+    const double omega { 2.0 * M_PI * freq / sampleRate };
+    const double alpha { std::sin(omega) / (2.0 * q) };
+    const double a0 { 1.0 / (1.0 + alpha / A) };
+    return { (1.0 + alpha * A) * a0, -2.0 * std::cos(omega) * a0, (1.0 - alpha * A) * a0, -2.0 * std::cos(omega) * a0, (1.0 - alpha / A) * a0 };
+}
+
+// Coefficients converted to the coefficient type of a filter
+template<typename Real, typename From>
+std::array<Real, 5> roundCoeffs(const std::array<From, 5>& c)
+{
+    return { static_cast<Real>(c[0]), static_cast<Real>(c[1]), static_cast<Real>(c[2]), static_cast<Real>(c[3]), static_cast<Real>(c[4]) };
+}
+
+// Largest absolute difference between two buffers
+template<typename SampleA, typename SampleB>
+double maxDifference(const Buffer<SampleA>& a, const Buffer<SampleB>& b, unsigned int numChannels, unsigned int numSamples)
+{
+    double diff { 0.0 };
+    for (unsigned int c = 0; c < numChannels; ++c)
+        for (unsigned int n = 0; n < numSamples; ++n)
+            diff = std::max(diff, std::abs(static_cast<double>(a[c][n]) - static_cast<double>(b[c][n])));
+
+    return diff;
+}
+
+// Ratio of the RMS difference between two buffers to the RMS of the reference, in dB
+template<typename Sample, typename Reference>
+double relativeErrorDb(const Buffer<Sample>& a, const Buffer<Reference>& reference, unsigned int numChannels, unsigned int numSamples)
+{
+    double error { 0.0 };
+    double power { 0.0 };
+    for (unsigned int c = 0; c < numChannels; ++c)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+        {
+            const double r { static_cast<double>(reference[c][n]) };
+            const double e { static_cast<double>(a[c][n]) - r };
+            error += e * e;
+            power += r * r;
+        }
+    }
+
+    return 10.0 * std::log10(error / power);
+}
+
+// Print a table cell of fixed width
+template<typename Value>
+void cell(const Value& value, int width = 12, int precision = 2)
+{
+    std::cout << std::setw(width) << std::fixed << std::setprecision(precision) << value;
+}
+
+}
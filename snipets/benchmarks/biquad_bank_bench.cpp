@@ -0,0 +1,72 @@
+// Throughput of mrta::BiquadBank against one mono mrta::Biquad object per filter,
+// from 1 to 4096 independent filters, each with its own coefficients
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/biquad_bank_bench.cpp dsp/Biquad.cpp dsp/BiquadBank.cpp -o biquad_bank_bench && ./biquad_bank_bench
+
+#include "Benchmark.h"
+#include "BiquadBank.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+int main()
+{
+    const unsigned int blockSize { 256 };
+
+    std::cout << "Single section filters, block of " << blockSize << " samples, lane width "
+              << mrta::BiquadBank::LaneWidth << ", ns per sample and filter" << std::endl;
+    std::cout << std::setw(10) << "filters" << std::setw(12) << "Biquads" << std::setw(12) << "bank"
+              << std::setw(14) << "interleaved" << std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+
+    for (unsigned int numFilters : { 1u, 4u, 16u, 64u, 256u, 512u, 1024u, 4096u })
+    {
+        mrta::BiquadBank bank { numFilters };
+        std::vector<std::unique_ptr<mrta::Biquad>> biquads;
+        for (unsigned int f = 0; f < numFilters; ++f)
+        {
+            // Peaks spread over the spectrum, as per voice filters would be
+            const double freq { 50.0 * std::pow(2.0, 8.0 * static_cast<double>(f % 97) / 97.0) };
+            const std::array<float, 5> c { bench::roundCoeffs<float>(bench::peakCoeffs(freq, 2.0, 6.0, 48000.0)) };
+            bank.setFilterCoeffs(c, f);
+
+            biquads.push_back(std::make_unique<mrta::Biquad>(1, 1));
+            biquads.back()->setSectionCoeffs(c, 0);
+        }
+
+        const bench::Buffer<float> input { numFilters, blockSize };
+        bench::Buffer<float> output { numFilters, blockSize };
+        bench::Buffer<float> expected { numFilters, blockSize };
+
+        const auto processBiquads = [&]
+        {
+            for (unsigned int f = 0; f < numFilters; ++f)
+                biquads[f]->process(expected.write() + f, input.read() + f, 1, blockSize);
+        };
+
+        bank.process(output.write(), input.read(), numFilters, blockSize);
+        processBiquads();
+        const double diff { bench::maxDifference(output, expected, numFilters, blockSize) };
+
+        // Frame-interleaved audio, sample n of filter f at [n * numFilters + f]
+        std::vector<float> interleavedInput(numFilters * blockSize);
+        std::vector<float> interleavedOutput(numFilters * blockSize);
+        for (unsigned int f = 0; f < numFilters; ++f)
+            for (unsigned int n = 0; n < blockSize; ++n)
+                interleavedInput[n * numFilters + f] = input[f][n];
+
+        const double samples { static_cast<double>(numFilters * blockSize) };
+        const double timeBiquads { bench::nsPerSample(processBiquads, samples) };
+        const double timeBank { bench::nsPerSample([&] { bank.process(output.write(), input.read(), numFilters, blockSize); }, samples) };
+        const double timeInterleaved { bench::nsPerSample([&] { bank.processInterleaved(interleavedOutput.data(), interleavedInput.data(), numFilters, blockSize); }, samples) };
+
+        bench::cell(numFilters, 10, 0);
+        bench::cell(timeBiquads, 12, 3);
+        bench::cell(timeBank, 12, 3);
+        bench::cell(timeInterleaved, 14, 3);
+        bench::cell(timeBiquads / std::min(timeBank, timeInterleaved), 10, 2);
+        std::cout << std::setw(12) << std::scientific << std::setprecision(1) << diff << std::endl;
+    }
+
+    return 0;
+}
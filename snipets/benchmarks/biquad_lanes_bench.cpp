@@ -0,0 +1,118 @@
+// Throughput of mrta::Biquad per channel count, against the baseline mrta::Biquad
+// it replaced, which processed one channel at a time. Channel groups of LaneWidth channels run in the vectorised kernel,
+// the leftover channels in its scalar tail
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/biquad_lanes_bench.cpp dsp/Biquad.cpp -o biquad_lanes_bench && ./biquad_lanes_bench
+
+#include "Benchmark.h"
+#include "Biquad.h"
+
+#include <array>
+#include <vector>
+
+// mrta::Biquad before the channel lanes, copied as it was: one channel at a time,
+// each sample thru every section, same operation order as the lanes
+class BaselineBiquad
+{
+public:
+    static const unsigned int CoeffsPerSection = 5;
+    static const unsigned int StatesPerSection = 4;
+
+    BaselineBiquad(unsigned int maxNumSections, unsigned int maxNumChannels) :
+        allocatedChannels { maxNumChannels },
+        allocatedSections { maxNumSections },
+        coeffs(allocatedSections * CoeffsPerSection, 0.f),
+        states(allocatedChannels * allocatedSections * StatesPerSection, 0.f)
+    { }
+
+    void setSectionCoeffs(const std::array<float, CoeffsPerSection>& newSectionCoeffs, unsigned int section)
+    {
+        if (section < allocatedSections)
+            std::copy(newSectionCoeffs.begin(), newSectionCoeffs.end(), coeffs.begin() + (section * CoeffsPerSection));
+    }
+
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+    {
+        numChannels = std::min(numChannels, allocatedChannels);
+        for (unsigned int c = 0; c < numChannels; ++c)
+        {
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                float x { input[c][n] };
+                for (unsigned int s = 0; s < allocatedSections; ++s)
+                {
+                    const unsigned int stateOffset { c * allocatedSections * StatesPerSection + s * StatesPerSection };
+                    const unsigned int coeffOffset { s * CoeffsPerSection };
+
+                    float acc { x * coeffs[coeffOffset + 0] }; // b0
+                    acc += coeffs[coeffOffset + 1] * states[stateOffset + 0]; // b1
+                    acc += coeffs[coeffOffset + 2] * states[stateOffset + 1]; // b2
+                    acc -= coeffs[coeffOffset + 3] * states[stateOffset + 2]; // a1
+                    acc -= coeffs[coeffOffset + 4] * states[stateOffset + 3]; // a2
+
+                    states[stateOffset + 1] = states[stateOffset + 0];
+                    states[stateOffset + 0] = x;
+                    states[stateOffset + 3] = states[stateOffset + 2];
+                    states[stateOffset + 2] = acc;
+                    x = acc;
+                }
+                output[c][n] = x;
+            }
+        }
+    }
+
+private:
+    unsigned int allocatedChannels { 0 };
+    unsigned int allocatedSections { 0 };
+    std::vector<float> coeffs;
+    std::vector<float> states;
+};
+
+int main()
+{
+    const unsigned int numSections { 8 };
+    const unsigned int blockSize { 512 };
+
+    std::cout << "Biquad, " << numSections << " sections, block of " << blockSize
+              << " samples, lane width " << mrta::Biquad::LaneWidth << std::endl;
+    std::cout << std::setw(10) << "channels" << std::setw(14) << "lanes ns" << std::setw(14) << "baseline ns"
+              << std::setw(10) << "speedup" << std::setw(14) << "max diff" << std::endl;
+
+    for (unsigned int numChannels : { 1u, 2u, 3u, 4u, 8u, 16u, 24u, 32u, 64u })
+    {
+        mrta::Biquad biquad { numSections, numChannels };
+        BaselineBiquad reference { numSections, numChannels };
+        for (unsigned int s = 0; s < numSections; ++s)
+        {
+            const float g { 0.01f * static_cast<float>(s) };
+            const std::array<float, 5> c { 0.2f + g, 0.3f, 0.1f, -0.5f + g, 0.3f - g };
+            biquad.setSectionCoeffs(c, s);
+            reference.setSectionCoeffs(c, s);
+        }
+
+        const bench::Buffer<float> input { numChannels, blockSize };
+        bench::Buffer<float> output { numChannels, blockSize };
+        bench::Buffer<float> expected { numChannels, blockSize };
+
+        // Both start from cleared states, so the first blocks can be compared
+        double diff { 0.0 };
+        for (unsigned int k = 0; k < 4; ++k)
+        {
+            biquad.process(output.write(), input.read(), numChannels, blockSize);
+            reference.process(expected.write(), input.read(), numChannels, blockSize);
+            diff = std::max(diff, bench::maxDifference(output, expected, numChannels, blockSize));
+        }
+
+        const double samples { static_cast<double>(numChannels * blockSize) };
+        const double lanes { bench::nsPerSample([&] { biquad.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+        const double baseline { bench::nsPerSample([&] { reference.process(expected.write(), input.read(), numChannels, blockSize); }, samples) };
+
+        bench::cell(numChannels, 10, 0);
+        bench::cell(lanes, 14, 3);
+        bench::cell(baseline, 14, 3);
+        bench::cell(baseline / lanes, 10, 2);
+        std::cout << std::setw(14) << std::scientific << std::setprecision(1) << diff << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Throughput and accuracy of float, mixed (double coefficients and states on float audio)
+// and double Direct Form I cascades
+// The accuracy is measured on the ParametricEQ plugin configuration at 192 kHz, with a
+// low shelf at 30 Hz: its DC gain from a step response, and the error of the float and
+// mixed equalizers against the double one on noise
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/biquad_precision_bench.cpp dsp/Biquad.cpp dsp/ParametricEqualizer.cpp dsp/FrequencyResponse.cpp -o biquad_precision_bench && ./biquad_precision_bench
+
+#include "Benchmark.h"
+#include "ParametricEqualizer.h"
+
+#include <array>
+#include <vector>
+
+using BiquadFloat = mrta::BiquadCascade<mrta::BiquadTopology::DirectFormI, float>;
+using BiquadDouble = mrta::BiquadCascade<mrta::BiquadTopology::DirectFormI, double>;
+
+template<typename Real>
+using Equalizer = mrta::FixedParametricEqualizer<3, 2, Real>;
+
+template<typename Real>
+void setupEqualizer(Equalizer<Real>& eq, double sampleRate)
+{
+    eq.prepare(sampleRate, 2);
+    eq.setBandType(0, Equalizer<Real>::LowShelf);
+    eq.setBandFrequency(0, 30.f);
+    eq.setBandGain(0, 12.f);
+    for (unsigned int b = 1; b < 3; ++b)
+    {
+        eq.setBandType(b, Equalizer<Real>::Peak);
+        eq.setBandFrequency(b, 1000.f * static_cast<float>(b));
+        eq.setBandGain(b, -6.f);
+    }
+
+    for (unsigned int b = 0; b < 3; ++b)
+        eq.setBandResonance(b, 0.7f);
+}
+
+// Gain in dB of the last sample of a long step response
+template<typename Real, typename Sample>
+double dcGainDb(Equalizer<Real>& eq, double sampleRate)
+{
+    const unsigned int numSamples { static_cast<unsigned int>(4.0 * sampleRate) };
+    std::vector<Sample> left(numSamples, Sample { 1 });
+    std::vector<Sample> right(numSamples, Sample { 1 });
+    Sample* const output[2] { left.data(), right.data() };
+
+    eq.clear();
+    eq.process(output, output, 2, numSamples);
+    eq.clear();
+
+    return 20.0 * std::log10(std::abs(static_cast<double>(left.back())));
+}
+
+void compareThroughput(unsigned int numSections, unsigned int numChannels, unsigned int blockSize)
+{
+    BiquadFloat single { numSections, numChannels };
+    BiquadDouble mixed { numSections, numChannels };
+    BiquadDouble full { numSections, numChannels };
+    for (unsigned int s = 0; s < numSections; ++s)
+    {
+        const std::array<double, 5> c { bench::peakCoeffs(100.0 * std::pow(2.0, static_cast<double>(s)), 1.0, s % 2 == 0 ? 6.0 : -6.0, 48000.0) };
+        single.setSectionCoeffs(bench::roundCoeffs<float>(c), s);
+        mixed.setSectionCoeffs(c, s);
+        full.setSectionCoeffs(c, s);
+    }
+
+    const bench::Buffer<float> input { numChannels, blockSize };
+    const bench::Buffer<double> inputDouble { numChannels, blockSize };
+    bench::Buffer<float> output { numChannels, blockSize };
+    bench::Buffer<double> outputDouble { numChannels, blockSize };
+
+    const double samples { static_cast<double>(numChannels * blockSize) };
+    const double timeFloat { bench::nsPerSample([&] { single.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+    const double timeMixed { bench::nsPerSample([&] { mixed.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+    const double timeDouble { bench::nsPerSample([&] { full.process(outputDouble.write(), inputDouble.read(), numChannels, blockSize); }, samples) };
+
+    bench::cell(numSections, 10, 0);
+    bench::cell(numChannels, 10, 0);
+    bench::cell(blockSize, 8, 0);
+    bench::cell(timeFloat, 10, 3);
+    bench::cell(timeMixed, 10, 3);
+    bench::cell(timeDouble, 10, 3);
+    bench::cell(timeMixed / timeFloat, 14, 2);
+    bench::cell(timeDouble / timeFloat, 14, 2);
+    std::cout << std::endl;
+}
+
+int main()
+{
+    std::cout << "Throughput, ns per sample and channel, cost relative to float" << std::endl;
+    std::cout << std::setw(10) << "sections" << std::setw(10) << "channels" << std::setw(8) << "block" << std::setw(10) << "float"
+              << std::setw(10) << "mixed" << std::setw(10) << "double" << std::setw(14) << "mixed/float" << std::setw(14) << "double/float" << std::endl;
+
+    for (unsigned int numChannels : { 2u, 16u })
+        for (unsigned int numSections : { 3u, 8u, 32u })
+            compareThroughput(numSections, numChannels, 512);
+
+    const double sampleRate { 192000.0 };
+    Equalizer<float> eqFloat { 3, 2 };
+    Equalizer<double> eqMixed { 3, 2 };
+    Equalizer<double> eqDouble { 3, 2 };
+    setupEqualizer(eqFloat, sampleRate);
+    setupEqualizer(eqMixed, sampleRate);
+    setupEqualizer(eqDouble, sampleRate);
+
+    std::cout << std::endl << "Low shelf 30 Hz +12 dB and two peaks at 192 kHz" << std::endl;
+    std::cout << std::setw(10) << "" << std::setw(12) << "DC gain" << std::endl;
+    std::cout << std::setw(10) << "float";
+    bench::cell(dcGainDb<float, float>(eqFloat, sampleRate), 12, 4);
+    std::cout << std::endl << std::setw(10) << "mixed";
+    bench::cell(dcGainDb<double, float>(eqMixed, sampleRate), 12, 4);
+    std::cout << std::endl << std::setw(10) << "double";
+    bench::cell(dcGainDb<double, double>(eqDouble, sampleRate), 12, 4);
+    std::cout << std::endl;
+
+    // About two seconds of noise, compared once the low shelf has settled
+    const unsigned int blockSize { 512 };
+    const unsigned int numBlocks { 2 * static_cast<unsigned int>(sampleRate) / blockSize };
+    double errorFloat { 0.0 };
+    double errorMixed { 0.0 };
+    for (unsigned int b = 0; b < numBlocks; ++b)
+    {
+        const bench::Buffer<float> input { 2, blockSize, b + 1 };
+        bench::Buffer<double> inputDouble { 2, blockSize };
+        for (unsigned int c = 0; c < 2; ++c)
+            std::copy(input[c].begin(), input[c].end(), inputDouble[c].begin());
+
+        bench::Buffer<float> outputFloat { 2, blockSize };
+        bench::Buffer<float> outputMixed { 2, blockSize };
+        bench::Buffer<double> expected { 2, blockSize };
+        eqFloat.process(outputFloat.write(), input.read(), 2, blockSize);
+        eqMixed.process(outputMixed.write(), input.read(), 2, blockSize);
+        eqDouble.process(expected.write(), inputDouble.read(), 2, blockSize);
+
+        if (b >= numBlocks / 2)
+        {
+            errorFloat += std::pow(10.0, bench::relativeErrorDb(outputFloat, expected, 2, blockSize) / 10.0);
+            errorMixed += std::pow(10.0, bench::relativeErrorDb(outputMixed, expected, 2, blockSize) / 10.0);
+        }
+    }
+
+    const double numCompared { static_cast<double>(numBlocks - numBlocks / 2) };
+    std::cout << std::endl << "Error against double on noise, relative to the output in dB" << std::endl;
+    std::cout << std::setw(10) << "float";
+    bench::cell(10.0 * std::log10(errorFloat / numCompared), 12, 1);
+    std::cout << std::endl << std::setw(10) << "mixed";
+    bench::cell(10.0 * std::log10(errorMixed / numCompared), 12, 1);
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Throughput of the SampleMajor and SectionMajor processing strategies of mrta::Biquad
+// for various block sizes and section counts
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/biquad_strategy_bench.cpp dsp/Biquad.cpp -o biquad_strategy_bench && ./biquad_strategy_bench
+
+#include "Benchmark.h"
+#include "Biquad.h"
+
+#include <array>
+
+template<typename Cascade>
+void compare(const char* name)
+{
+    std::cout << name << ", ns per sample and channel" << std::endl;
+    std::cout << std::setw(10) << "channels" << std::setw(10) << "sections" << std::setw(8) << "block"
+              << std::setw(14) << "SampleMajor" << std::setw(14) << "SectionMajor" << std::setw(10) << "speedup" << std::endl;
+
+    const std::array<float, 5> c { 0.2f, 0.3f, 0.1f, -0.5f, 0.3f };
+    for (unsigned int numChannels : { 2u, 16u })
+    {
+        for (unsigned int numSections : { 2u, 8u, 16u, 32u })
+        {
+            for (unsigned int blockSize : { 32u, 128u, 512u, 2048u })
+            {
+                Cascade sampleMajor { numSections, numChannels };
+                Cascade sectionMajor { numSections, numChannels };
+                sectionMajor.setProcessingStrategy(Cascade::SectionMajor);
+                for (unsigned int s = 0; s < numSections; ++s)
+                {
+                    sampleMajor.setSectionCoeffs(c, s);
+                    sectionMajor.setSectionCoeffs(c, s);
+                }
+
+                const bench::Buffer<float> input { numChannels, blockSize };
+                bench::Buffer<float> output { numChannels, blockSize };
+
+                const double samples { static_cast<double>(numChannels * blockSize) };
+                const double timeSample { bench::nsPerSample([&] { sampleMajor.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+                const double timeSection { bench::nsPerSample([&] { sectionMajor.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+
+                bench::cell(numChannels, 10, 0);
+                bench::cell(numSections, 10, 0);
+                bench::cell(blockSize, 8, 0);
+                bench::cell(timeSample, 14, 3);
+                bench::cell(timeSection, 14, 3);
+                bench::cell(timeSample / timeSection, 10, 2);
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    compare<mrta::Biquad>("Direct Form I");
+    compare<mrta::BiquadTDF2>("Transposed Direct Form II");
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Throughput and numerical noise of the Direct Form I and Transposed Direct Form II
+// topologies of mrta::BiquadCascade
+// The noise is the error of the float cascades against a double cascade with the same
+// (float rounded) coefficients, so it only measures the rounding of the processing
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/biquad_topology_bench.cpp dsp/Biquad.cpp -o biquad_topology_bench && ./biquad_topology_bench
+
+#include "Benchmark.h"
+#include "Biquad.h"
+
+#include <array>
+#include <vector>
+
+using BiquadDouble = mrta::BiquadCascade<mrta::BiquadTopology::DirectFormI, double>;
+
+// Float and double cascades of peaks at the given frequencies, alternating boosts and cuts
+template<typename Cascade>
+void setPeaks(Cascade& cascade, const std::vector<double>& freqs, double sampleRate)
+{
+    for (unsigned int s = 0; s < freqs.size(); ++s)
+    {
+        const std::array<double, 5> c { bench::peakCoeffs(freqs[s], 2.0, s % 2 == 0 ? 9.0 : -9.0, sampleRate) };
+        cascade.setSectionCoeffs(bench::roundCoeffs<typename Cascade::CoeffType>(bench::roundCoeffs<float>(c)), s);
+    }
+}
+
+void compareNoise(const char* name, const std::vector<double>& freqs, double sampleRate)
+{
+    const unsigned int numSections { static_cast<unsigned int>(freqs.size()) };
+    const unsigned int blockSize { 512 };
+    const unsigned int numBlocks { static_cast<unsigned int>(sampleRate) / blockSize };
+
+    mrta::Biquad dfi { numSections, 1 };
+    mrta::BiquadTDF2 tdf2 { numSections, 1 };
+    BiquadDouble reference { numSections, 1 };
+    setPeaks(dfi, freqs, sampleRate);
+    setPeaks(tdf2, freqs, sampleRate);
+    setPeaks(reference, freqs, sampleRate);
+
+    // About a second of noise, compared once the filters have settled
+    double errorDfi { 0.0 };
+    double errorTdf2 { 0.0 };
+    for (unsigned int b = 0; b < numBlocks; ++b)
+    {
+        const bench::Buffer<float> input { 1, blockSize, b + 1 };
+        bench::Buffer<double> inputDouble { 1, blockSize };
+        std::copy(input[0].begin(), input[0].end(), inputDouble[0].begin());
+
+        bench::Buffer<float> outputDfi { 1, blockSize };
+        bench::Buffer<float> outputTdf2 { 1, blockSize };
+        bench::Buffer<double> expected { 1, blockSize };
+        dfi.process(outputDfi.write(), input.read(), 1, blockSize);
+        tdf2.process(outputTdf2.write(), input.read(), 1, blockSize);
+        reference.process(expected.write(), inputDouble.read(), 1, blockSize);
+
+        if (b >= numBlocks / 2)
+        {
+            errorDfi += std::pow(10.0, bench::relativeErrorDb(outputDfi, expected, 1, blockSize) / 10.0);
+            errorTdf2 += std::pow(10.0, bench::relativeErrorDb(outputTdf2, expected, 1, blockSize) / 10.0);
+        }
+    }
+
+    const double numCompared { static_cast<double>(numBlocks - numBlocks / 2) };
+    std::cout << std::setw(34) << std::left << name << std::right;
+    bench::cell(10.0 * std::log10(errorDfi / numCompared), 12, 1);
+    bench::cell(10.0 * std::log10(errorTdf2 / numCompared), 12, 1);
+    std::cout << std::endl;
+}
+
+int main()
+{
+    const unsigned int blockSize { 512 };
+    const std::array<float, 5> c { 0.2f, 0.3f, 0.1f, -0.5f, 0.3f };
+
+    std::cout << "Throughput, block of " << blockSize << " samples, ns per sample and channel" << std::endl;
+    std::cout << std::setw(10) << "sections" << std::setw(10) << "channels" << std::setw(12) << "DF-I" << std::setw(12) << "TDF-II"
+              << std::setw(10) << "speedup" << std::setw(16) << "states DF-I" << std::setw(16) << "states TDF-II" << std::endl;
+
+    for (unsigned int numChannels : { 2u, 16u })
+    {
+        for (unsigned int numSections : { 1u, 8u, 32u, 128u })
+        {
+            mrta::Biquad dfi { numSections, numChannels };
+            mrta::BiquadTDF2 tdf2 { numSections, numChannels };
+            for (unsigned int s = 0; s < numSections; ++s)
+            {
+                dfi.setSectionCoeffs(c, s);
+                tdf2.setSectionCoeffs(c, s);
+            }
+
+            const bench::Buffer<float> input { numChannels, blockSize };
+            bench::Buffer<float> output { numChannels, blockSize };
+
+            const double samples { static_cast<double>(numChannels * blockSize) };
+            const double timeDfi { bench::nsPerSample([&] { dfi.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+            const double timeTdf2 { bench::nsPerSample([&] { tdf2.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+
+            // State memory of all channels in bytes
+            const unsigned int statesDfi { numChannels * numSections * mrta::Biquad::StatesPerSection * static_cast<unsigned int>(sizeof(float)) };
+            const unsigned int statesTdf2 { numChannels * numSections * mrta::BiquadTDF2::StatesPerSection * static_cast<unsigned int>(sizeof(float)) };
+
+            bench::cell(numSections, 10, 0);
+            bench::cell(numChannels, 10, 0);
+            bench::cell(timeDfi, 12, 3);
+            bench::cell(timeTdf2, 12, 3);
+            bench::cell(timeDfi / timeTdf2, 10, 2);
+            bench::cell(statesDfi, 16, 0);
+            bench::cell(statesTdf2, 16, 0);
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "Float noise against double, error to output power in dB" << std::endl;
+    std::cout << std::setw(34) << std::left << "cascade" << std::right << std::setw(12) << "DF-I" << std::setw(12) << "TDF-II" << std::endl;
+    compareNoise("4 peaks 1-8 kHz at 48 kHz", { 1000.0, 2000.0, 4000.0, 8000.0 }, 48000.0);
+    compareNoise("4 peaks 40-320 Hz at 48 kHz", { 40.0, 80.0, 160.0, 320.0 }, 48000.0);
+    compareNoise("4 peaks 40-320 Hz at 192 kHz", { 40.0, 80.0, 160.0, 320.0 }, 192000.0);
+
+    return 0;
+}
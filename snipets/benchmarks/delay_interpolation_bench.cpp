@@ -0,0 +1,111 @@
+// CPU cost and quality of the DelayInterpolation policies of mrta::DelayLine
+// The cost is the modulated process with a Flanger like sweep, block and single sample
+// The quality is the error of a sine read at a fractional delay of 100.5 samples, the
+// worst case fraction, against the ideal delayed sine, relative to its power
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/delay_interpolation_bench.cpp dsp/DelayLine.cpp dsp/DelayInterpolation.cpp -o delay_interpolation_bench && ./delay_interpolation_bench
+
+#include "Benchmark.h"
+#include "DelayLine.h"
+
+#include <array>
+
+constexpr unsigned int MaxLengthSamples { 3000 };
+constexpr unsigned int NumChannels { 2 };
+constexpr unsigned int BlockSize { 256 };
+constexpr double SampleRate { 48000.0 };
+
+const std::array<double, 5> frequencies { 1000.0, 4000.0, 10000.0, 16000.0, 20000.0 };
+
+// Error in dB of a sine at freq delayed by 100.5 samples
+template<typename Interpolation>
+double sineErrorDb(double freq)
+{
+    mrta::DelayLine delayLine { MaxLengthSamples, 1 };
+    delayLine.setDelaySamples(100.f);
+
+    const double delay { 100.5 };
+    const double omega { 2.0 * M_PI * freq / SampleRate };
+    bench::Buffer<float> input { 1, BlockSize };
+    bench::Buffer<float> modulation { 1, BlockSize };
+    bench::Buffer<float> output { 1, BlockSize };
+    bench::Buffer<double> expected { 1, BlockSize };
+    std::fill(modulation[0].begin(), modulation[0].end(), 0.5f);
+
+    // The first blocks fill the delay line and settle the recursive policies
+    double error { 0.0 };
+    const unsigned int numBlocks { 16 };
+    for (unsigned int b = 0; b < numBlocks; ++b)
+    {
+        for (unsigned int n = 0; n < BlockSize; ++n)
+        {
+            const double t { static_cast<double>(b * BlockSize + n) };
+            input[0][n] = static_cast<float>(std::sin(omega * t));
+            expected[0][n] = std::sin(omega * (t - delay));
+        }
+
+        delayLine.process<Interpolation>(output.write(), input.read(), modulation.read(), 1, BlockSize);
+        if (b >= numBlocks / 2)
+            error += std::pow(10.0, bench::relativeErrorDb(output, expected, 1, BlockSize) / 10.0);
+    }
+
+    return 10.0 * std::log10(error / static_cast<double>(numBlocks - numBlocks / 2));
+}
+
+template<typename Interpolation>
+void measure(const char* name, const bench::Buffer<float>& input, const bench::Buffer<float>& modulation)
+{
+    mrta::DelayLine delayLine { MaxLengthSamples, NumChannels };
+    delayLine.setDelaySamples(100.f);
+    bench::Buffer<float> output { NumChannels, BlockSize };
+
+    const auto processSamples = [&]
+    {
+        for (unsigned int n = 0; n < BlockSize; ++n)
+        {
+            const float x[NumChannels] { input[0][n], input[1][n] };
+            const float m[NumChannels] { modulation[0][n], modulation[1][n] };
+            float y[NumChannels];
+            delayLine.process<Interpolation>(y, x, m, NumChannels);
+            output[0][n] = y[0];
+            output[1][n] = y[1];
+        }
+    };
+
+    const double samples { static_cast<double>(NumChannels * BlockSize) };
+    const double timeBlock { bench::nsPerSample([&] { delayLine.process<Interpolation>(output.write(), input.read(), modulation.read(), NumChannels, BlockSize); }, samples) };
+    const double timeSample { bench::nsPerSample(processSamples, samples) };
+
+    std::cout << std::setw(14) << std::left << name << std::right;
+    bench::cell(timeBlock, 8, 2);
+    bench::cell(timeSample, 8, 2);
+    for (double freq : frequencies)
+        bench::cell(sineErrorDb<Interpolation>(freq), 9, 1);
+    std::cout << std::endl;
+}
+
+int main()
+{
+    const bench::Buffer<float> input { NumChannels, BlockSize };
+
+    // Sweep between 100 and 1300 samples on top of the set delay
+    bench::Buffer<float> modulation { NumChannels, BlockSize };
+    for (unsigned int ch = 0; ch < NumChannels; ++ch)
+        for (unsigned int n = 0; n < BlockSize; ++n)
+            modulation[ch][n] = 700.f + 600.f * std::sin(0.02f * static_cast<float>(n) + static_cast<float>(ch));
+
+    std::cout << "Modulated process, " << NumChannels << " channels, block of " << BlockSize << " samples, ns per sample and channel" << std::endl;
+    std::cout << "Error in dB of a sine delayed by 100.5 samples at 48 kHz" << std::endl;
+    std::cout << std::setw(14) << std::left << "policy" << std::right << std::setw(8) << "block" << std::setw(8) << "sample";
+    for (double freq : frequencies)
+        std::cout << std::setw(8) << static_cast<int>(freq / 1000.0) << "k";
+    std::cout << std::endl;
+
+    measure<mrta::DelayInterpolation::Linear>("Linear", input, modulation);
+    measure<mrta::DelayInterpolation::Lagrange3>("Lagrange3", input, modulation);
+    measure<mrta::DelayInterpolation::Hermite3>("Hermite3", input, modulation);
+    measure<mrta::DelayInterpolation::Thiran1>("Thiran1", input, modulation);
+    measure<mrta::DelayInterpolation::WindowedSinc>("WindowedSinc", input, modulation);
+
+    return 0;
+}
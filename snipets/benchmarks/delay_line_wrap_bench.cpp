@@ -0,0 +1,105 @@
+// Throughput of the Modulo and PowerOfTwo wrap modes of mrta::DelayLine, for the block
+// and single sample process methods, with a fixed and a modulated delay time
+// The single sample modulated process is the Flanger use case
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/delay_line_wrap_bench.cpp dsp/DelayLine.cpp dsp/DelayInterpolation.cpp -o delay_line_wrap_bench && ./delay_line_wrap_bench
+
+#include "Benchmark.h"
+#include "DelayLine.h"
+
+#include <functional>
+
+// Length of the delay lines, not a power of two so PowerOfTwo rounds it up to 4096
+constexpr unsigned int MaxLengthSamples { 3000 };
+constexpr unsigned int NumChannels { 2 };
+constexpr unsigned int BlockSize { 256 };
+
+using Process = std::function<void(mrta::DelayLine&, bench::Buffer<float>&)>;
+
+void compare(const char* name, float delaySamples, const Process& process)
+{
+    mrta::DelayLine modulo { MaxLengthSamples, NumChannels, mrta::DelayLine::Modulo };
+    mrta::DelayLine powerOfTwo { MaxLengthSamples, NumChannels, mrta::DelayLine::PowerOfTwo };
+    modulo.setDelaySamples(delaySamples);
+    powerOfTwo.setDelaySamples(delaySamples);
+
+    bench::Buffer<float> output { NumChannels, BlockSize };
+    bench::Buffer<float> expected { NumChannels, BlockSize };
+
+    // Enough blocks for both buffers to wrap around a few times
+    double diff { 0.0 };
+    for (unsigned int b = 0; b < 64; ++b)
+    {
+        process(modulo, expected);
+        process(powerOfTwo, output);
+        diff = std::max(diff, bench::maxDifference(output, expected, NumChannels, BlockSize));
+    }
+
+    const double samples { static_cast<double>(NumChannels * BlockSize) };
+    const double timeModulo { bench::nsPerSample([&] { process(modulo, output); }, samples) };
+    const double timePowerOfTwo { bench::nsPerSample([&] { process(powerOfTwo, output); }, samples) };
+
+    std::cout << std::setw(34) << std::left << name << std::right;
+    bench::cell(timeModulo, 10, 3);
+    bench::cell(timePowerOfTwo, 12, 3);
+    bench::cell(timeModulo / timePowerOfTwo, 10, 2);
+    std::cout << std::setw(12) << std::scientific << std::setprecision(1) << diff << std::endl;
+}
+
+int main()
+{
+    const bench::Buffer<float> input { NumChannels, BlockSize };
+
+    // Flanger like sweep between 100 and 1300 samples on top of the set delay
+    bench::Buffer<float> modulation { NumChannels, BlockSize };
+    for (unsigned int ch = 0; ch < NumChannels; ++ch)
+        for (unsigned int n = 0; n < BlockSize; ++n)
+            modulation[ch][n] = 700.f + 600.f * std::sin(0.02f * static_cast<float>(n) + static_cast<float>(ch));
+
+    std::cout << NumChannels << " channels of " << MaxLengthSamples << " samples, block of " << BlockSize
+              << " samples, linear interpolation, ns per sample and channel" << std::endl;
+    std::cout << std::setw(34) << std::left << "process" << std::right << std::setw(10) << "Modulo" << std::setw(12) << "PowerOfTwo"
+              << std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+
+    compare("block, integer delay", 1500.f, [&](mrta::DelayLine& d, bench::Buffer<float>& out)
+    {
+        d.process(out.write(), input.read(), NumChannels, BlockSize);
+    });
+
+    compare("block, fractional delay", 1500.5f, [&](mrta::DelayLine& d, bench::Buffer<float>& out)
+    {
+        d.process(out.write(), input.read(), NumChannels, BlockSize);
+    });
+
+    compare("block, modulated", 100.f, [&](mrta::DelayLine& d, bench::Buffer<float>& out)
+    {
+        d.process(out.write(), input.read(), modulation.read(), NumChannels, BlockSize);
+    });
+
+    compare("single sample, fractional delay", 1500.5f, [&](mrta::DelayLine& d, bench::Buffer<float>& out)
+    {
+        for (unsigned int n = 0; n < BlockSize; ++n)
+        {
+            const float x[NumChannels] { input[0][n], input[1][n] };
+            float y[NumChannels];
+            d.process(y, x, NumChannels);
+            out[0][n] = y[0];
+            out[1][n] = y[1];
+        }
+    });
+
+    compare("single sample, modulated", 100.f, [&](mrta::DelayLine& d, bench::Buffer<float>& out)
+    {
+        for (unsigned int n = 0; n < BlockSize; ++n)
+        {
+            const float x[NumChannels] { input[0][n], input[1][n] };
+            const float m[NumChannels] { modulation[0][n], modulation[1][n] };
+            float y[NumChannels];
+            d.process(y, x, m, NumChannels);
+            out[0][n] = y[0];
+            out[1][n] = y[1];
+        }
+    });
+
+    return 0;
+}
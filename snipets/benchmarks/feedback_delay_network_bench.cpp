@@ -0,0 +1,53 @@
+// CPU cost of one mrta::FeedbackDelayNetwork instance processing stereo audio,
+// at 48 and 96 kHz, with 8 and 16 lines and both feedback matrices
+// The load is the time per stereo frame times the sample rate, in percent of one core
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/feedback_delay_network_bench.cpp dsp/FeedbackDelayNetwork.cpp dsp/DelayLine.cpp dsp/DelayInterpolation.cpp dsp/BiquadBank.cpp dsp/Biquad.cpp -o feedback_delay_network_bench && ./feedback_delay_network_bench
+
+#include "Benchmark.h"
+#include "FeedbackDelayNetwork.h"
+
+int main()
+{
+    const unsigned int numChannels { 2 };
+    const float maxSizeMs { 100.f };
+
+    std::cout << "Stereo, size 60 ms, decay 2 s, ns per frame and percent of one core" << std::endl;
+    std::cout << std::setw(10) << "rate" << std::setw(8) << "block" << std::setw(8) << "lines" << std::setw(14) << "matrix"
+              << std::setw(12) << "ns/frame" << std::setw(10) << "% core" << std::endl;
+
+    for (double sampleRate : { 48000.0, 96000.0 })
+    {
+        for (unsigned int blockSize : { 64u, 512u })
+        {
+            for (unsigned int numLines : { 8u, 16u })
+            {
+                for (auto matrix : { mrta::FeedbackDelayNetwork::Hadamard, mrta::FeedbackDelayNetwork::Householder })
+                {
+                    mrta::FeedbackDelayNetwork fdn { maxSizeMs, numLines };
+                    fdn.prepare(sampleRate, maxSizeMs);
+                    fdn.setFeedbackMatrix(matrix);
+                    fdn.setSize(60.f);
+                    fdn.setDecayTime(2.f);
+                    fdn.setDamping(0.5f);
+                    fdn.setDampingFrequency(6000.f);
+
+                    const bench::Buffer<float> input { numChannels, blockSize };
+                    bench::Buffer<float> output { numChannels, blockSize };
+
+                    const double timeFrame { bench::nsPerSample([&] { fdn.process(output.write(), input.read(), numChannels, blockSize); }, blockSize) };
+
+                    bench::cell(sampleRate, 10, 0);
+                    bench::cell(blockSize, 8, 0);
+                    bench::cell(numLines, 8, 0);
+                    std::cout << std::setw(14) << (matrix == mrta::FeedbackDelayNetwork::Hadamard ? "Hadamard" : "Householder");
+                    bench::cell(timeFrame, 12, 2);
+                    bench::cell(100.0 * timeFrame * 1e-9 * sampleRate, 10, 3);
+                    std::cout << std::endl;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
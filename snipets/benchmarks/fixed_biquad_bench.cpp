@@ -0,0 +1,64 @@
+// Throughput of mrta::FixedBiquad, with the sections and channels known at compile time,
+// against mrta::BiquadCascade with the same sections, channels and coefficient type
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/fixed_biquad_bench.cpp dsp/Biquad.cpp -o fixed_biquad_bench && ./fixed_biquad_bench
+
+#include "Benchmark.h"
+#include "FixedBiquad.h"
+
+#include <array>
+
+template<unsigned int NumSections, unsigned int NumChannels, typename Real>
+void compare(const char* realName, unsigned int blockSize)
+{
+    mrta::FixedBiquad<NumSections, NumChannels, mrta::BiquadTopology::DirectFormI, Real> fixed;
+    mrta::BiquadCascade<mrta::BiquadTopology::DirectFormI, Real> dynamic { NumSections, NumChannels };
+    for (unsigned int s = 0; s < NumSections; ++s)
+    {
+        const double freq { 100.0 * std::pow(2.0, static_cast<double>(s)) };
+        const std::array<Real, 5> c { bench::roundCoeffs<Real>(bench::peakCoeffs(freq, 1.0, s % 2 == 0 ? 6.0 : -6.0, 48000.0)) };
+        fixed.setSectionCoeffs(c, s);
+        dynamic.setSectionCoeffs(c, s);
+    }
+
+    const bench::Buffer<float> input { NumChannels, blockSize };
+    bench::Buffer<float> output { NumChannels, blockSize };
+    bench::Buffer<float> expected { NumChannels, blockSize };
+
+    fixed.process(output.write(), input.read(), NumChannels, blockSize);
+    dynamic.process(expected.write(), input.read(), NumChannels, blockSize);
+    const double diff { bench::maxDifference(output, expected, NumChannels, blockSize) };
+
+    const double samples { static_cast<double>(NumChannels * blockSize) };
+    const double timeFixed { bench::nsPerSample([&] { fixed.process(output.write(), input.read(), NumChannels, blockSize); }, samples) };
+    const double timeDynamic { bench::nsPerSample([&] { dynamic.process(expected.write(), input.read(), NumChannels, blockSize); }, samples) };
+
+    bench::cell(NumSections, 10, 0);
+    bench::cell(NumChannels, 10, 0);
+    std::cout << std::setw(8) << realName;
+    bench::cell(blockSize, 8, 0);
+    bench::cell(timeDynamic, 12, 3);
+    bench::cell(timeFixed, 12, 3);
+    bench::cell(timeDynamic / timeFixed, 10, 2);
+    std::cout << std::setw(12) << std::scientific << std::setprecision(1) << diff << std::endl;
+}
+
+int main()
+{
+    std::cout << "Direct Form I, float audio, ns per sample and channel" << std::endl;
+    std::cout << std::setw(10) << "sections" << std::setw(10) << "channels" << std::setw(8) << "coeffs" << std::setw(8) << "block"
+              << std::setw(12) << "Biquad" << std::setw(12) << "Fixed" << std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+
+    for (unsigned int blockSize : { 32u, 512u })
+    {
+        // The ParametricEQ plugin configuration
+        compare<3, 2, float>("float", blockSize);
+        compare<3, 2, double>("double", blockSize);
+        compare<8, 2, float>("float", blockSize);
+        compare<8, 2, double>("double", blockSize);
+        compare<3, 16, float>("float", blockSize);
+        compare<8, 16, float>("float", blockSize);
+    }
+
+    return 0;
+}
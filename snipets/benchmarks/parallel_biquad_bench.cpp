@@ -0,0 +1,121 @@
+// Throughput and accuracy of mrta::ParallelBiquad against the serial mrta::Biquad cascade
+// it is converted from, for graphic equalizers of 4 to 32 bands
+// The accuracy is the response error reported by ParallelBiquad::getResponseError and
+// the time domain error of both float realisations against a double cascade
+// Build and run from the repository root:
+// g++ -std=c++17 -O3 -march=native -Idsp -Isnipets/benchmarks snipets/benchmarks/parallel_biquad_bench.cpp dsp/Biquad.cpp dsp/ParallelBiquad.cpp -o parallel_biquad_bench && ./parallel_biquad_bench
+
+#include "Benchmark.h"
+#include "ParallelBiquad.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+using BiquadDouble = mrta::BiquadCascade<mrta::BiquadTopology::DirectFormI, double>;
+
+// Log spaced peaks from 31.25 Hz to 16 kHz with random gains in [-9, 9] dB
+std::vector<std::array<float, 5>> graphicEqualizer(unsigned int numBands, double sampleRate)
+{
+    std::mt19937 rng { numBands };
+    std::uniform_real_distribution<double> gain { -9.0, 9.0 };
+
+    // Bandwidth of one band in octaves sets the Q
+    const double octaves { 9.0 / static_cast<double>(numBands) };
+    const double q { std::sqrt(std::pow(2.0, octaves)) / (std::pow(2.0, octaves) - 1.0) };
+
+    std::vector<std::array<float, 5>> coeffs;
+    for (unsigned int b = 0; b < numBands; ++b)
+    {
+        const double freq { 31.25 * std::pow(2.0, octaves * (static_cast<double>(b) + 0.5)) };
+        coeffs.push_back(bench::roundCoeffs<float>(bench::peakCoeffs(freq, q, gain(rng), sampleRate)));
+    }
+
+    return coeffs;
+}
+
+int main()
+{
+    const double sampleRate { 48000.0 };
+    const unsigned int blockSize { 512 };
+
+    std::cout << "Graphic equalizer at 48 kHz, block of " << blockSize << " samples, lane width "
+              << mrta::ParallelBiquad::LaneWidth << std::endl;
+    std::cout << "Time in ns per sample and channel, errors relative to the output in dB" << std::endl;
+    std::cout << std::setw(8) << "bands" << std::setw(10) << "channels" << std::setw(10) << "serial" << std::setw(10) << "parallel"
+              << std::setw(10) << "speedup" << std::setw(12) << "response" << std::setw(14) << "err serial" << std::setw(14) << "err parallel" << std::endl;
+
+    for (unsigned int numBands : { 4u, 8u, 16u, 32u })
+    {
+        const std::vector<std::array<float, 5>> coeffs { graphicEqualizer(numBands, sampleRate) };
+
+        std::vector<std::array<float, mrta::ParallelBiquad::ParallelCoeffsPerSection>> parallelCoeffs;
+        float directGain { 0.f };
+        if (!mrta::ParallelBiquad::convert(coeffs, parallelCoeffs, directGain))
+        {
+            std::cout << std::setw(8) << numBands << "  conversion failed" << std::endl;
+            continue;
+        }
+
+        const double responseError { mrta::ParallelBiquad::getResponseError(coeffs, parallelCoeffs, directGain) };
+
+        for (unsigned int numChannels : { 2u, 16u })
+        {
+            mrta::Biquad serial { numBands, numChannels };
+            BiquadDouble reference { numBands, numChannels };
+            for (unsigned int s = 0; s < numBands; ++s)
+            {
+                serial.setSectionCoeffs(coeffs[s], s);
+                reference.setSectionCoeffs(bench::roundCoeffs<double>(coeffs[s]), s);
+            }
+
+            mrta::ParallelBiquad parallel { numBands, numChannels };
+            parallel.setCascade(coeffs);
+
+            // Error over a second of noise, once the filters have settled
+            double serialError { 0.0 };
+            double parallelError { 0.0 };
+            const unsigned int numBlocks { static_cast<unsigned int>(sampleRate) / blockSize };
+            for (unsigned int b = 0; b < numBlocks; ++b)
+            {
+                const bench::Buffer<float> input { numChannels, blockSize, b + 1 };
+                bench::Buffer<double> inputDouble { numChannels, blockSize };
+                for (unsigned int c = 0; c < numChannels; ++c)
+                    std::copy(input[c].begin(), input[c].end(), inputDouble[c].begin());
+
+                bench::Buffer<float> outputSerial { numChannels, blockSize };
+                bench::Buffer<float> outputParallel { numChannels, blockSize };
+                bench::Buffer<double> expected { numChannels, blockSize };
+                serial.process(outputSerial.write(), input.read(), numChannels, blockSize);
+                parallel.process(outputParallel.write(), input.read(), numChannels, blockSize);
+                reference.process(expected.write(), inputDouble.read(), numChannels, blockSize);
+
+                if (b >= numBlocks / 2)
+                {
+                    serialError += std::pow(10.0, bench::relativeErrorDb(outputSerial, expected, numChannels, blockSize) / 10.0);
+                    parallelError += std::pow(10.0, bench::relativeErrorDb(outputParallel, expected, numChannels, blockSize) / 10.0);
+                }
+            }
+
+            const double numCompared { static_cast<double>(numBlocks - numBlocks / 2) };
+
+            const bench::Buffer<float> input { numChannels, blockSize };
+            bench::Buffer<float> output { numChannels, blockSize };
+            const double samples { static_cast<double>(numChannels * blockSize) };
+            const double timeSerial { bench::nsPerSample([&] { serial.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+            const double timeParallel { bench::nsPerSample([&] { parallel.process(output.write(), input.read(), numChannels, blockSize); }, samples) };
+
+            bench::cell(numBands, 8, 0);
+            bench::cell(numChannels, 10, 0);
+            bench::cell(timeSerial, 10, 2);
+            bench::cell(timeParallel, 10, 2);
+            bench::cell(timeSerial / timeParallel, 10, 2);
+            bench::cell(20.0 * std::log10(responseError), 12, 1);
+            bench::cell(10.0 * std::log10(serialError / numCompared), 14, 1);
+            bench::cell(10.0 * std::log10(parallelError / numCompared), 14, 1);
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
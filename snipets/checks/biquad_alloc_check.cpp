@@ -0,0 +1,153 @@
+// Checks that once storage is reserved, changing the number of sections and channels
+// of a Biquad, and preparing an equalizer again, never allocates
+// Build and run from the repository root:
+// g++ -std=c++17 -O2 -Idsp snipets/checks/biquad_alloc_check.cpp dsp/Biquad.cpp dsp/ParametricEqualizer.cpp dsp/FrequencyResponse.cpp -o biquad_alloc_check && ./biquad_alloc_check
+
+#include "Biquad.h"
+#include "ParametricEqualizer.h"
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+// Number of heap allocations while counting is on
+static unsigned int numAllocations { 0 };
+static bool countAllocations { false };
+
+// The replaced new and delete are a matched malloc/free pair, GCC still warns about the free
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Replace the global allocation functions, every other new and delete
+// operator forwards to these two
+void* operator new(std::size_t size)
+{
+    if (countAllocations)
+        ++numAllocations;
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic pop
+#endif
+
+// Run f and return the number of allocations it made
+template<typename Function>
+unsigned int allocationsOf(Function&& f)
+{
+    numAllocations = 0;
+    countAllocations = true;
+    f();
+    countAllocations = false;
+    return numAllocations;
+}
+
+bool report(const char* name, unsigned int allocations, bool expectAllocations = false)
+{
+    std::cout << name << ": " << allocations << " allocations" << std::endl;
+    return expectAllocations ? allocations > 0 : allocations == 0;
+}
+
+int main()
+{
+    const unsigned int maxSections { 8 };
+    const unsigned int maxChannels { 8 };
+    const unsigned int blockSize { 256 };
+
+    std::vector<std::vector<float>> buffers(maxChannels, std::vector<float>(blockSize, 0.5f));
+    std::vector<float*> channels;
+    for (auto& b : buffers)
+        channels.push_back(b.data());
+
+    const std::array<float, 5> lowpass { 0.2f, 0.4f, 0.2f, -0.6f, 0.2f };
+
+    mrta::Biquad biquad;
+    biquad.reserve(maxSections, maxChannels);
+
+    bool passed { true };
+
+    // Make sure allocations are actually seen
+    passed &= report("Biquad reserve above the capacity", allocationsOf([&] { biquad.reserve(maxSections + 1, maxChannels + 1); }), true);
+    biquad.reserve(maxSections, maxChannels);
+
+    // Change the section and channel counts in use between blocks, as a host changing
+    // the band count or channel layout on the audio thread would
+    passed &= report("Biquad setNumSections and setNumChannels", allocationsOf([&]
+    {
+        for (unsigned int k = 0; k < 4 * maxSections; ++k)
+        {
+            const unsigned int numSections { 1 + (k * 5) % maxSections };
+            const unsigned int numChannels { 1 + (k * 3) % maxChannels };
+            biquad.setNumSections(numSections);
+            biquad.setNumChannels(numChannels);
+            for (unsigned int s = 0; s < numSections; ++s)
+                biquad.setSectionCoeffs(lowpass, s);
+
+            biquad.process(channels.data(), channels.data(), numChannels, blockSize);
+        }
+    }));
+
+    passed &= report("Biquad reallocate within the capacity", allocationsOf([&]
+    {
+        for (unsigned int k = 1; k <= maxSections; ++k)
+        {
+            biquad.reallocateSections(k);
+            biquad.reallocateChannels(1 + maxChannels - k);
+            biquad.process(channels.data(), channels.data(), 1 + maxChannels - k, blockSize);
+        }
+    }));
+
+    // prepareToPlay calls prepare again, with the channel count given to the ctor or less
+    mrta::ParametricEqualizer eq { 3, 2 };
+    passed &= report("ParametricEqualizer prepare", allocationsOf([&]
+    {
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 48000.0 })
+        {
+            for (unsigned int numChannels : { 2u, 1u })
+            {
+                eq.prepare(sampleRate, numChannels);
+                eq.setBandType(0, mrta::ParametricEqualizer::LowShelf);
+                eq.setBandGain(0, 3.f);
+                eq.setBandFrequency(1, 1000.f);
+                eq.process(channels.data(), channels.data(), numChannels, blockSize);
+            }
+        }
+    }));
+
+    mrta::FixedParametricEqualizer<3, 2, double> fixedEq { 3, 2 };
+    passed &= report("FixedParametricEqualizer prepare", allocationsOf([&]
+    {
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 48000.0 })
+        {
+            for (unsigned int numChannels : { 2u, 1u })
+            {
+                fixedEq.prepare(sampleRate, numChannels);
+                fixedEq.setBandType(0, mrta::ParametricEqualizer::LowShelf);
+                fixedEq.setBandGain(0, 3.f);
+                fixedEq.setBandFrequency(1, 1000.f);
+                fixedEq.process(channels.data(), channels.data(), numChannels, blockSize);
+            }
+        }
+    }));
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// Checks that a peak band reset to 0 dB stops being processed while audio is playing,
+// without changing the output beyond rounding
+// Build and run from the repository root:
+// g++ -std=c++17 -O2 -Idsp snipets/checks/biquad_drain_check.cpp dsp/Biquad.cpp -o biquad_drain_check && ./biquad_drain_check
+
+#include "Biquad.h"
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Windows does not have Pi constants
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+// Peak filter coefficients, same design as mrta::ParametricEqualizer
+std::array<double, 5> peakCoeffs(double freq, double q, double gainDb, double sampleRate)
+{
+    const double A { std::sqrt(std::pow(10.0, gainDb * 0.05)) };
+    const double omega { 2.0 * M_PI * freq / sampleRate };
+    const double alpha { std::sin(omega) / (2.0 * q) };
+    const double a0 { 1.0 / (1.0 + alpha / A) };
+    return { (1.0 + alpha * A) * a0, -2.0 * std::cos(omega) * a0, (1.0 - alpha * A) * a0, -2.0 * std::cos(omega) * a0, (1.0 - alpha / A) * a0 };
+}
+
+// Direct Form I section in double, never bypassed, as reference
+// New coeffs are interpolated over a block like mrta::Biquad does
+struct ReferenceSection
+{
+    std::array<double, 5> c {};
+    std::array<double, 5> step {};
+    double bz1 { 0.0 }, bz2 { 0.0 }, az1 { 0.0 }, az2 { 0.0 };
+
+    void setCoeffs(const std::array<double, 5>& target, unsigned int blockSize)
+    {
+        for (unsigned int k = 0; k < 5; ++k)
+            step[k] = (target[k] - c[k]) / blockSize;
+    }
+
+    void process(std::vector<double>& output, const std::vector<float>& input)
+    {
+        const std::array<double, 5> start { c };
+        for (unsigned int n = 0; n < input.size(); ++n)
+        {
+            for (unsigned int k = 0; k < 5; ++k)
+                c[k] = start[k] + (n + 1) * step[k];
+
+            const double x { input[n] };
+            const double y { c[0] * x + c[1] * bz1 + c[2] * bz2 - c[3] * az1 - c[4] * az2 };
+            bz2 = bz1; bz1 = x; az2 = az1; az1 = y;
+            output[n] = y;
+        }
+
+        step.fill(0.0);
+    }
+};
+
+// return true if the section is bypassed within maxBlocks after the reset to 0 dB
+template<typename Cascade>
+bool checkDrain(const char* name, double freq)
+{
+    const double sampleRate { 48000.0 };
+    const unsigned int blockSize { 256 };
+    const unsigned int maxBlocks { 2000 };
+
+    Cascade biquad(1, 1);
+    ReferenceSection reference;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::vector<float> buffer(blockSize);
+    float* channels[1] { buffer.data() };
+
+    // Coeffs rounded to float, so the reference only differs by the rounding of the processing
+    // The first coeffs are applied without interpolation
+    auto setCoeffs = [&](double gainDb, bool interpolate)
+    {
+        const std::array<double, 5> design { peakCoeffs(freq, 2.0, gainDb, sampleRate) };
+        std::array<float, 5> c;
+        std::array<double, 5> rounded;
+        for (unsigned int k = 0; k < 5; ++k)
+            rounded[k] = c[k] = static_cast<float>(design[k]);
+
+        if (interpolate)
+            reference.setCoeffs(rounded, blockSize);
+        else
+            reference.c = rounded;
+
+        biquad.setSectionCoeffs(c, 0);
+    };
+
+    setCoeffs(6.0, false);
+
+    // Play about a second of noise, then reset the band to 0 dB, and keep playing
+    // until 200 blocks after the section is bypassed
+    // Error of the float processing while the peak is on, and error once the section is bypassed
+    unsigned int bypassedBlock { 0 };
+    double roundingError { 0.0 };
+    double bypassError { 0.0 };
+    std::vector<double> expected(blockSize);
+    for (unsigned int b = 0; b < maxBlocks && (bypassedBlock == 0 || b < bypassedBlock + 200); ++b)
+    {
+        if (b == 200)
+            setCoeffs(0.0, true);
+
+        for (auto& x : buffer)
+            x = noise(rng);
+
+        reference.process(expected, buffer);
+        biquad.process(channels, channels, 1, blockSize);
+
+        double& maxError { b < 200 ? roundingError : bypassError };
+        if (b < 200 || bypassedBlock > 0)
+            for (unsigned int n = 0; n < blockSize; ++n)
+                maxError = std::fmax(maxError, std::fabs(buffer[n] - expected[n]));
+
+        if (b >= 200 && bypassedBlock == 0 && biquad.getActiveSections() == 0)
+            bypassedBlock = b;
+    }
+
+    const bool bypassed { bypassedBlock > 0 };
+    std::cout << name << " " << freq << " Hz peak at 0 dB: ";
+    if (bypassed)
+        std::cout << "bypassed " << (bypassedBlock - 200) << " blocks after the reset";
+    else
+        std::cout << "still processed " << maxBlocks - 200 << " blocks after the reset";
+
+    std::cout << ", max error vs reference " << bypassError << " once bypassed (" << roundingError << " with the peak on)" << std::endl;
+
+    // Bypassing cuts no more than the rounding of the processing
+    return bypassed && bypassError <= roundingError;
+}
+
+int main()
+{
+    bool passed { true };
+    for (double freq : { 30.0, 100.0, 1000.0, 10000.0 })
+    {
+        passed &= checkDrain<mrta::Biquad>("Direct Form I", freq);
+        passed &= checkDrain<mrta::BiquadTDF2>("Transposed Direct Form II", freq);
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
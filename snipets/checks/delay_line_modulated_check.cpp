@@ -0,0 +1,125 @@
+// Checks that the block modulated process of DelayLine, which reads chunks of samples in
+// vectorised loops, gives exactly the output of the single sample modulated process,
+// for every interpolation policy, wrap mode and layout
+// Build and run from the repository root:
+// g++ -std=c++17 -O2 -Idsp snipets/checks/delay_line_modulated_check.cpp dsp/DelayLine.cpp dsp/DelayInterpolation.cpp -o delay_line_modulated_check && ./delay_line_modulated_check
+
+#include "DelayLine.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// return true if the block and single sample outputs are identical
+template<typename Interpolation>
+bool checkModulated(const char* name, mrta::DelayLine::WrapMode wrapMode, mrta::DelayLine::Layout layout)
+{
+    const unsigned int maxLengthSamples { 1000 };
+    const unsigned int numChannels { 2 };
+    const unsigned int numBlocks { 400 };
+
+    mrta::DelayLine block(maxLengthSamples, numChannels, wrapMode, layout);
+    mrta::DelayLine single(maxLengthSamples, numChannels, wrapMode, layout);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::uniform_int_distribution<unsigned int> blockSize(1, 300);
+    std::uniform_real_distribution<float> delay(1.f, 200.f);
+
+    // Modulation from below 0 to beyond the length of the delay line, so the delays are
+    // clamped at both ends, and every chunk mixes in range and clamped samples now and then
+    std::uniform_real_distribution<float> depth(0.f, 1.2f * maxLengthSamples);
+    std::uniform_real_distribution<float> rate(0.001f, 0.2f);
+
+    std::vector<float> input[numChannels];
+    std::vector<float> modulation[numChannels];
+    std::vector<float> output[numChannels];
+    std::vector<float> expected[numChannels];
+
+    float maxDiff { 0.f };
+    unsigned int numDiff { 0 };
+    float phase { 0.f };
+    for (unsigned int b = 0; b < numBlocks; ++b)
+    {
+        const unsigned int numSamples { blockSize(rng) };
+        const float delaySamples { delay(rng) };
+        const float modDepth { depth(rng) };
+        const float modRate { rate(rng) };
+
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            input[ch].resize(numSamples);
+            modulation[ch].resize(numSamples);
+            output[ch].resize(numSamples);
+            expected[ch].resize(numSamples);
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                input[ch][n] = noise(rng);
+                modulation[ch][n] = modDepth * std::sin(phase + modRate * n + ch) - 0.1f * modDepth;
+            }
+        }
+
+        phase += modRate * numSamples;
+
+        block.setDelaySamples(delaySamples);
+        single.setDelaySamples(delaySamples);
+
+        const float* inputs[numChannels] { input[0].data(), input[1].data() };
+        const float* mods[numChannels] { modulation[0].data(), modulation[1].data() };
+        float* outputs[numChannels] { output[0].data(), output[1].data() };
+        block.process<Interpolation>(outputs, inputs, mods, numChannels, numSamples);
+
+        for (unsigned int n = 0; n < numSamples; ++n)
+        {
+            const float x[numChannels] { input[0][n], input[1][n] };
+            const float m[numChannels] { modulation[0][n], modulation[1][n] };
+            float y[numChannels];
+            single.process<Interpolation>(y, x, m, numChannels);
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                expected[ch][n] = y[ch];
+        }
+
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                const float diff { std::fabs(output[ch][n] - expected[ch][n]) };
+                // NaN outputs count as differences too
+                if (!(diff == 0.f))
+                    ++numDiff;
+                maxDiff = std::fmax(maxDiff, diff);
+            }
+        }
+    }
+
+    std::cout << name << (wrapMode == mrta::DelayLine::Modulo ? ", Modulo" : ", PowerOfTwo")
+              << (layout == mrta::DelayLine::Planar ? ", Planar" : ", Interleaved")
+              << ": " << numDiff << " samples differ, max difference " << maxDiff << std::endl;
+
+    return numDiff == 0;
+}
+
+template<typename Interpolation>
+bool checkPolicy(const char* name)
+{
+    bool passed { true };
+    for (auto wrapMode : { mrta::DelayLine::Modulo, mrta::DelayLine::PowerOfTwo })
+        for (auto layout : { mrta::DelayLine::Planar, mrta::DelayLine::Interleaved })
+            passed &= checkModulated<Interpolation>(name, wrapMode, layout);
+
+    return passed;
+}
+
+int main()
+{
+    bool passed { true };
+    passed &= checkPolicy<mrta::DelayInterpolation::Linear>("Linear");
+    passed &= checkPolicy<mrta::DelayInterpolation::Lagrange3>("Lagrange3");
+    passed &= checkPolicy<mrta::DelayInterpolation::Hermite3>("Hermite3");
+    passed &= checkPolicy<mrta::DelayInterpolation::Thiran1>("Thiran1");
+    passed &= checkPolicy<mrta::DelayInterpolation::WindowedSinc>("WindowedSinc");
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}